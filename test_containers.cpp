@@ -0,0 +1,180 @@
+// Standard container memory behavior: iteration bandwidth and lookup latency
+// for vector, deque, list, map, unordered_map and a sorted-vector flat map,
+// at the buffer sizes the latency tests derive from the cache hierarchy.
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <map>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "test_mem_bandwidth.h"
+
+#define CONTAINER_TARGET_BYTES MB_TO_BYTES(256)  // Payload bytes iterated per container measurement
+
+// Payload stored in every container: a key and the key of the next element
+// to look up, so lookups form a dependent chain like the pointer chase
+struct element_t {
+    uint64_t key;
+    uint64_t next;
+};
+
+using flat_map_t = std::vector<std::pair<uint64_t, uint64_t>>;
+
+static volatile uint64_t sink;
+
+// Keys 0..count-1 chained in one random cycle: next[k] is the key after k
+static std::vector<uint64_t> make_lookup_cycle(size_t count, std::mt19937_64& rng) {
+    std::vector<uint64_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<uint64_t> next(count);
+    for (size_t i = 0; i < count; i++) {
+        next[order[i]] = order[(i + 1) % count];
+    }
+    return next;
+}
+
+// Time `passes` full passes summing every element's payload, after one
+// untimed warmup pass
+template <typename Container, typename Sum>
+static double time_iteration(const Container& c, Sum sum_of, int passes) {
+    uint64_t sum = 0;
+    for (const auto& item : c) sum += sum_of(item);
+    double start_time = get_time();
+    for (int iter = 0; iter < passes; iter++) {
+        for (const auto& item : c) sum += sum_of(item);
+    }
+    double elapsed = get_time() - start_time;
+    sink = sum;
+    return elapsed;
+}
+
+// Time LATENCY_ACCESSES dependent lookups; find(key) returns the next key
+template <typename Find>
+static double time_lookups(Find find) {
+    uint64_t key = 0;
+    double start_time = get_time();
+    for (size_t i = 0; i < LATENCY_ACCESSES; i++) {
+        key = find(key);
+    }
+    double elapsed = get_time() - start_time;
+    sink = key;
+    return elapsed;
+}
+
+static void run_container_size(size_t buffer_size, const char* size_name, std::mt19937_64& rng) {
+    size_t count = buffer_size / sizeof(element_t);
+    if (count < 2) return;
+    size_t payload = count * sizeof(element_t);
+    std::vector<uint64_t> next = make_lookup_cycle(count, rng);
+    // Small sizes take many passes so each measurement is long enough to time
+    int passes = (int)(CONTAINER_TARGET_BYTES / payload);
+    if (passes < ITERATIONS) passes = ITERATIONS;
+
+    printf("\n%s: %zu elements of %zu bytes\n", size_name, count, sizeof(element_t));
+    printf("--------------------------------------------------------------------------------\n");
+    auto payload_sum = [](const element_t& e) { return e.key + e.next; };
+    auto pair_sum = [](const std::pair<const uint64_t, uint64_t>& p) { return p.first + p.second; };
+
+    {
+        std::vector<element_t> v(count);
+        for (size_t k = 0; k < count; k++) v[k] = {k, next[k]};
+        display_bandwidth("vector iter", time_iteration(v, payload_sum, passes), payload, passes);
+        display_latency("vector index", time_lookups([&](uint64_t k) { return v[k].next; }),
+                        LATENCY_ACCESSES, buffer_size);
+    }
+    {
+        std::deque<element_t> d;
+        for (size_t k = 0; k < count; k++) d.push_back({k, next[k]});
+        display_bandwidth("deque iter", time_iteration(d, payload_sum, passes), payload, passes);
+        display_latency("deque index", time_lookups([&](uint64_t k) { return d[k].next; }),
+                        LATENCY_ACCESSES, buffer_size);
+    }
+    {
+        // Insert in random order so nodes are not laid out in list order
+        std::vector<uint64_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), rng);
+        std::list<element_t> l;
+        for (size_t i = 0; i < count; i++) {
+            element_t e = {order[i], next[order[i]]};
+            if (i % 2) l.push_back(e);
+            else l.push_front(e);
+        }
+        display_bandwidth("list iter", time_iteration(l, payload_sum, passes), payload, passes);
+    }
+    {
+        std::map<uint64_t, uint64_t> m;
+        for (size_t k = 0; k < count; k++) m.emplace(next[k], next[next[k]]);  // Random insertion order
+        display_bandwidth("map iter", time_iteration(m, pair_sum, passes), payload, passes);
+        display_latency("map find", time_lookups([&](uint64_t k) { return m.find(k)->second; }),
+                        LATENCY_ACCESSES, buffer_size);
+    }
+    {
+        std::unordered_map<uint64_t, uint64_t> u;
+        u.reserve(count);
+        for (size_t k = 0; k < count; k++) u.emplace(k, next[k]);
+        display_bandwidth("umap iter", time_iteration(u, pair_sum, passes), payload, passes);
+        display_latency("umap find", time_lookups([&](uint64_t k) { return u.find(k)->second; }),
+                        LATENCY_ACCESSES, buffer_size);
+    }
+    {
+        flat_map_t f(count);
+        for (size_t k = 0; k < count; k++) f[k] = {k, next[k]};
+        auto flat_sum = [](const std::pair<uint64_t, uint64_t>& p) { return p.first + p.second; };
+        display_bandwidth("flat iter", time_iteration(f, flat_sum, passes), payload, passes);
+        display_latency("flat find", time_lookups([&](uint64_t k) {
+                            auto it = std::lower_bound(f.begin(), f.end(), std::make_pair(k, uint64_t(0)));
+                            return it->second;
+                        }),
+                        LATENCY_ACCESSES, buffer_size);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            printf("Usage: %s\n", argv[0]);
+            printf("  Container iteration bandwidth and lookup latency at cache-derived sizes\n");
+            return 0;
+        }
+        fprintf(stderr, "Unknown option: %s\n", argv[i]);
+        return 1;
+    }
+
+    printf("Container Memory Test\n");
+    printf("===========================\n");
+    printf("Iterate bytes per test: %zu MB (at least %d passes)\n", CONTAINER_TARGET_BYTES / MB_TO_BYTES(1), ITERATIONS);
+    printf("Lookups per test: %d\n", LATENCY_ACCESSES);
+
+    read_cache_info();
+    display_cache_hierarchy();
+
+    size_t* test_sizes;
+    char** size_names;
+    int num_tests;
+    generate_dynamic_test_sizes(&test_sizes, &size_names, &num_tests);
+
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < num_tests; i++) {
+        run_container_size(test_sizes[i], size_names[i], rng);
+    }
+    free_dynamic_test_sizes(test_sizes, size_names, num_tests);
+
+    printf("\nNotes:\n");
+    printf("- Sizes are the latency test buffer sizes; element counts are size / %zu-byte payloads\n", sizeof(element_t));
+    printf("- Iterate bandwidth counts payload bytes only, not node, bucket or block overhead\n");
+    printf("- Lookups are dependent: each found value is the next key, so latency is not overlapped\n");
+    printf("- Lookups use random keys; list has no lookup, and index is positional access for vector/deque\n");
+    printf("- umap is std::unordered_map; flat is a sorted vector of pairs searched with lower_bound\n");
+    printf("- Cache Level is judged from the payload size, so node-based containers can spill a level earlier\n");
+    return 0;
+}
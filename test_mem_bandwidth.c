@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
@@ -6,14 +7,82 @@
 #include <unistd.h>
 #include <stdint.h>
 #include <dirent.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <errno.h>
+#include <malloc.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#include <cpuid.h>
+#define HAVE_X86_INTRINSICS 1
+#endif
+#include "test_mem_bandwidth.h"
 
 #define DEFAULT_SIZE_MB 64
-#define ITERATIONS 3
 #define RANDOM_ACCESSES 1000000  // Number of random accesses per iteration
-#define LATENCY_ACCESSES 1000000  // Reduced for pointer chasing - each access is serialized
-#define MB_TO_BYTES(mb) ((size_t)(mb) * 1024 * 1024)
-#define KB_TO_BYTES(kb) ((size_t)(kb) * 1024)
 #define MAX_CACHE_LEVELS 4
+#define CHECKSUM_TARGET_BYTES MB_TO_BYTES(128)  // Bytes hashed per thread for each size/kernel pair
+#define STRING_TARGET_BYTES MB_TO_BYTES(256)    // Bytes scanned per string primitive measurement
+#define SPMV_ITERATIONS 10                      // SpMV passes per measurement
+#define SPMV_NNZ_PER_ROW 16                     // Average non-zeros per matrix row
+#define GRAPH_EDGE_FACTOR 8                     // Undirected edges per vertex (16 adjacency entries)
+#define GRAPH_BFS_ROOTS 4                       // BFS roots averaged per graph
+#define PAGERANK_ITERATIONS 10
+#define TRANSPOSE_RECURSION_BASE 32             // Cache-oblivious transpose switches to a loop below this
+#define STENCIL_STEPS 8                         // Jacobi sweeps per stencil measurement
+#define STENCIL_TIME_BLOCK 4                    // Sweeps fused per tile by temporal blocking
+#define MAX_CPUS 1024
+#define POLLUTION_RAMP_SECONDS 0.01             // Aggressor runs alone this long before the victim measures
+#define PREFETCH_DISTANCE_LINES 16              // Software prefetch distance in cache lines
+#define PREFETCH_PASSES 3                       // Kernel passes per hint measurement
+#define RESIDENCY_PROBE_LINES 4096              // Lines sampled by the residency probe
+#define INCLUSIVITY_TRIALS 3                    // Back-invalidation trials per mode (median is kept)
+#define REPLACEMENT_MAX_SLOTS 8                 // Sequence visits per line per period (one pointer word each)
+#define REPLACEMENT_MISS_FACTOR 16              // Per-set miss reference cycles this many times the ways
+#define COHERENCE_LINES 512                     // Lines handed between cores (32 KB, fits the owner's L1)
+#define COHERENCE_TRIALS 5                      // Runs per state (median is kept)
+#define DRAM_ROUNDS 15                          // Timed repetitions per DRAM measurement (median is kept)
+#define DRAM_SCAN_STRIDE 256                    // Spacing of candidate lines in the bank scan
+#define DRAM_BLP_LINES 8                        // Loads issued together for bank parallelism
+#define PAGE_COLOR_TRIALS 8                     // Fresh buffers measured per coloring mode
+#define PAGE_COLOR_POOL_FACTOR 4                // Pages faulted in per page kept (per allowed color share)
+#define PAGE_COLOR_READ_PASSES 20               // Sequential read passes per bandwidth sample
+#define TRACE_SAMPLES (1 << 20)                 // Timestamps per latency trace
+#define TRACE_SAMPLE_NS 250.0                   // Target chase time between timestamps
+#define TRACE_LAG_BINS 1000                     // Autocorrelation histogram resolution
+#define TRACE_MAX_PARTNERS 64                   // Successors examined per spike when correlating
+#define NUMA_MAX_NODES 64                       // Nodes representable in one nodemask word
+#define NUMA_SAMPLE_PAGES 1024                  // Pages queried with move_pages to report placement
+#define AUTONUMA_SECONDS 10                     // How long to let NUMA balancing work
+#define AUTONUMA_MAX_ROUNDS 4096
+#define AUTONUMA_CONVERGED 0.9                  // Share of local pages that counts as converged
+#define AGING_SECONDS 10                        // Default churn duration
+#define AGING_MIN_OBJECT 16                     // Object sizes are log-uniform in [min, max) bytes
+#define AGING_MAX_OBJECT (64 * 1024)
+#define AGING_BURST_INTERVAL 256                // Replacements between bursts of short-lived objects
+#define AGING_BURST_OBJECTS 64
+#define XCHECK_SCALAR 3.0                       // STREAM scale/triad constant
+#define XCHECK_EMPTY_REGIONS 100                // Empty parallel regions timed for fork/join cost
+#define TRACE_RING_EVENTS 65536                 // Events kept per worker ring (newest win)
+#define TRACE_MIN_SLOTS 4                       // Worker rings allocated even for fewer --threads
+#define TRACE_LABEL_CHARS 32                    // Counter track name length
+#define REPORT_LABEL_CHARS 64                   // Result label length kept for the report
+#define REPORT_MAX_THREAD_STEPS 16              // Thread counts in the report's scaling sweep
+#define HISTORY_TEST_CHARS 96                   // Test id length in the results history
+#define HISTORY_RECENT_RUNS 3                   // Latest runs averaged for drift
+#define HISTORY_MIN_TREND_DAYS 7                // History span needed before a trend is printed
+#define HISTORY_MIN_SEGMENT 3                   // Runs on each side of a change point
+#define HISTORY_MAX_CHANGES 4                   // Change points reported per metric
+#define HISTORY_CHANGE_T 4.0                    // Welch t statistic a mean shift must exceed
+#define HISTORY_MIN_SHIFT 0.02                  // ...and relative size (2%)
 
 // Cache information structure
 typedef struct {
@@ -29,6 +98,11 @@ typedef struct {
 static cache_info_t cache_levels[MAX_CACHE_LEVELS];
 static int num_cache_levels = 0;
 
+// Last-level cache inclusivity, set by the --inclusivity probes
+typedef enum { LLC_UNKNOWN, LLC_INCLUSIVE, LLC_NON_INCLUSIVE, LLC_EXCLUSIVE } llc_inclusivity_t;
+static llc_inclusivity_t llc_inclusivity = LLC_UNKNOWN;
+static size_t llc_effective_bytes = 0;  // Capacity one core can keep on chip, 0 if not probed
+
 // Latency measurement results
 typedef struct {
     const char* size_name;
@@ -99,8 +173,20 @@ void read_cache_info() {
             fclose(fp);
         }
         
-        // Determine actual cache level based on type and size
-        if (strcmp(cache->type, "Data") == 0 || strcmp(cache->type, "Instruction") == 0) {
+        // Prefer the level reported by the kernel; fall back to guessing from type and size
+        cache->level = 0;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/level", index);
+        fp = fopen(path, "r");
+        if (fp) {
+            if (fgets(buffer, sizeof(buffer), fp)) {
+                cache->level = atoi(buffer);
+            }
+            fclose(fp);
+        }
+        
+        if (cache->level > 0) {
+            // Level read from sysfs
+        } else if (strcmp(cache->type, "Data") == 0 || strcmp(cache->type, "Instruction") == 0) {
             cache->level = 1;  // L1 cache
         } else if (strcmp(cache->type, "Unified") == 0) {
             // For unified caches, determine level by size
@@ -156,6 +242,10 @@ const char* analyze_cache_level(size_t buffer_size, double latency_ns) {
             cache_info_t* cache = &cache_levels[i];
             if (strcmp(cache->type, "Data") == 0 || strcmp(cache->type, "Unified") == 0) {
                 size_t cache_size_bytes = cache->size_kb * 1024;
+                // An exclusive LLC holds lines the inner levels do not, so it serves more than its size
+                if (i == num_cache_levels - 1 && llc_effective_bytes > cache_size_bytes) {
+                    cache_size_bytes = llc_effective_bytes;
+                }
                 if (buffer_size <= cache_size_bytes) {
                     static char level_str[32];
                     snprintf(level_str, sizeof(level_str), "L%d Cache", cache->level);
@@ -181,6 +271,118 @@ const char* analyze_cache_level(size_t buffer_size, double latency_ns) {
     }
 }
 
+// Size in bytes of the data or unified cache at `level`, or `fallback` if it was not detected
+size_t find_cache_size(int level, size_t fallback) {
+    for (int i = 0; i < num_cache_levels; i++) {
+        if (cache_levels[i].level == level && strcmp(cache_levels[i].type, "Instruction") != 0) {
+            return cache_levels[i].size_kb * 1024;
+        }
+    }
+    return fallback;
+}
+
+// Associativity of the data or unified cache at `level`, or `fallback` if it was not detected
+int find_cache_ways(int level, int fallback) {
+    for (int i = 0; i < num_cache_levels; i++) {
+        if (cache_levels[i].level == level && strcmp(cache_levels[i].type, "Instruction") != 0) {
+            return cache_levels[i].associativity > 0 ? cache_levels[i].associativity : fallback;
+        }
+    }
+    return fallback;
+}
+
+// Parse a sysfs CPU list such as "0-3,8-11" into cpus[]; returns the number of CPUs
+int parse_cpu_list(const char* list, int* cpus, int max_cpus) {
+    int count = 0;
+    const char* p = list;
+    while (*p && *p != '\n' && count < max_cpus) {
+        char* end;
+        long first = strtol(p, &end, 10);
+        if (end == p) break;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long cpu = first; cpu <= last && count < max_cpus; cpu++) {
+            cpus[count++] = (int)cpu;
+        }
+        if (*p == ',') p++;
+    }
+    return count;
+}
+
+// Read a CPU list file from sysfs; returns the number of CPUs or 0 if unavailable
+int read_cpu_list_file(const char* path, int* cpus, int max_cpus) {
+    char buffer[4096];
+    FILE* fp = fopen(path, "r");
+    if (!fp) return 0;
+    int count = 0;
+    if (fgets(buffer, sizeof(buffer), fp)) {
+        count = parse_cpu_list(buffer, cpus, max_cpus);
+    }
+    fclose(fp);
+    return count;
+}
+
+// CPUs sharing the cache at `level` with `cpu`; returns the count or 0 if unknown
+int read_cache_shared_cpus(int cpu, int level, int* cpus, int max_cpus) {
+    char path[256];
+    char buffer[64];
+    for (int index = 0; index < MAX_CACHE_LEVELS * 2; index++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", cpu, index);
+        FILE* fp = fopen(path, "r");
+        if (!fp) break;
+        int this_level = 0;
+        if (fgets(buffer, sizeof(buffer), fp)) this_level = atoi(buffer);
+        fclose(fp);
+        if (this_level == level) {
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", cpu, index);
+            return read_cpu_list_file(path, cpus, max_cpus);
+        }
+    }
+    return 0;
+}
+
+static int cpu_in_list(int cpu, const int* cpus, int count) {
+    for (int i = 0; i < count; i++) {
+        if (cpus[i] == cpu) return 1;
+    }
+    return 0;
+}
+
+// Pick a CPU other than `cpu` that shares its last-level cache, preferring one
+// on a different physical core. Returns `cpu` itself if no other CPU exists.
+int find_llc_neighbor_cpu(int cpu) {
+    static int shared[MAX_CPUS], siblings[MAX_CPUS], online[MAX_CPUS];
+    char path[256];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+    int num_siblings = read_cpu_list_file(path, siblings, MAX_CPUS);
+    int num_shared = read_cache_shared_cpus(cpu, 3, shared, MAX_CPUS);
+    if (num_shared == 0) num_shared = read_cache_shared_cpus(cpu, 2, shared, MAX_CPUS);
+    
+    for (int i = 0; i < num_shared; i++) {
+        if (shared[i] != cpu && !cpu_in_list(shared[i], siblings, num_siblings)) return shared[i];
+    }
+    for (int i = 0; i < num_shared; i++) {
+        if (shared[i] != cpu) return shared[i];
+    }
+    int num_online = read_cpu_list_file("/sys/devices/system/cpu/online", online, MAX_CPUS);
+    for (int i = 0; i < num_online; i++) {
+        if (online[i] != cpu) return online[i];
+    }
+    return cpu;
+}
+
+// Pin the calling thread to one CPU; returns 0 on failure
+int pin_thread_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
 // Utility function to get current time in seconds
 double get_time() {
     struct timespec ts;
@@ -206,6 +408,21 @@ void generate_random_indices(size_t* indices, size_t count, size_t max_index) {
     }
 }
 
+// Small fast PRNG for generators that need many more numbers than rand() comfortably provides
+static inline uint64_t xorshift64(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+// Uniform double in [0, 1)
+static inline double xorshift64_unit(uint64_t* state) {
+    return (double)(xorshift64(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
 // Aligned memory allocation function
 void* aligned_malloc(size_t alignment, size_t size) {
     void* ptr;
@@ -215,6 +432,324 @@ void* aligned_malloc(size_t alignment, size_t size) {
     return ptr;
 }
 
+// Chrome trace-event recording for the thread engine (--trace-json). Each
+// worker slot has a preallocated ring, written only by the thread in that
+// slot; the extra last ring holds counter samples from the main thread.
+typedef struct {
+    const char* name;             // Span name, or NULL for a counter sample
+    double ts;                    // get_time() seconds
+    double dur;
+    double value;                 // Counter value
+    uint32_t run;                 // run_threaded call the span belongs to
+    char label[TRACE_LABEL_CHARS];  // Counter track name
+} trace_event_t;
+
+// One cache line per ring so workers bumping `written` do not share lines
+typedef struct {
+    trace_event_t* events;
+    size_t written;               // Total recorded; the ring keeps the newest TRACE_RING_EVENTS
+    char pad[64 - sizeof(trace_event_t*) - sizeof(size_t)];
+} trace_ring_t;
+
+static trace_ring_t* trace_rings;  // NULL while tracing is off
+static int trace_slots;
+static uint32_t trace_run;
+static size_t trace_out_of_range;  // Spans from worker slots past trace_slots
+static double trace_origin;
+
+static inline trace_event_t* trace_next_event(int slot) {
+    trace_ring_t* ring = &trace_rings[slot];
+    return &ring->events[ring->written++ % TRACE_RING_EVENTS];
+}
+
+// Allocate and prefault one ring per worker slot plus one for counters.
+// Returns 0 on success.
+int trace_enable(int num_threads) {
+    trace_slots = num_threads > TRACE_MIN_SLOTS ? num_threads : TRACE_MIN_SLOTS;
+    trace_rings = aligned_malloc(64, (trace_slots + 1) * sizeof(trace_ring_t));
+    if (!trace_rings) return -1;
+    memset(trace_rings, 0, (trace_slots + 1) * sizeof(trace_ring_t));
+    for (int i = 0; i <= trace_slots; i++) {
+        trace_rings[i].events = malloc(TRACE_RING_EVENTS * sizeof(trace_event_t));
+        if (!trace_rings[i].events) return -1;
+        memset(trace_rings[i].events, 0, TRACE_RING_EVENTS * sizeof(trace_event_t));
+    }
+    trace_origin = get_time();
+    return 0;
+}
+
+void trace_disable(void) {
+    if (!trace_rings) return;
+    for (int i = 0; i <= trace_slots; i++) free(trace_rings[i].events);
+    free(trace_rings);
+    trace_rings = NULL;
+}
+
+void trace_span(int slot, const char* name, double start, double end) {
+    if (slot >= trace_slots) {
+        trace_out_of_range++;
+        return;
+    }
+    trace_event_t* e = trace_next_event(slot);
+    e->name = name;
+    e->ts = start;
+    e->dur = end - start;
+    e->run = trace_run;
+}
+
+// Counter sample on the track `label`; main thread only
+void trace_counter(const char* label, double value) {
+    if (!trace_rings) return;
+    trace_event_t* e = trace_next_event(trace_slots);
+    e->name = NULL;
+    e->ts = get_time();
+    e->value = value;
+    snprintf(e->label, sizeof(e->label), "%s", label);
+}
+
+// Write every ring as Chrome trace-event JSON (chrome://tracing, Perfetto).
+// Returns 0 on success.
+int trace_write_json(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return -1;
+    size_t dropped = 0;
+    fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"test_mem_bandwidth\"}}");
+    for (int slot = 0; slot <= trace_slots; slot++) {
+        trace_ring_t* ring = &trace_rings[slot];
+        if (ring->written == 0) continue;
+        size_t kept = ring->written < TRACE_RING_EVENTS ? ring->written : TRACE_RING_EVENTS;
+        dropped += ring->written - kept;
+        if (slot < trace_slots) {
+            fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"worker %d\"}}",
+                    slot, slot);
+        }
+        for (size_t i = ring->written - kept; i < ring->written; i++) {
+            const trace_event_t* e = &ring->events[i % TRACE_RING_EVENTS];
+            double ts_us = (e->ts - trace_origin) * 1e6;
+            if (e->name) {
+                fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                        "\"args\":{\"run\":%u}}", e->name, slot, ts_us, e->dur * 1e6, e->run);
+            } else {
+                fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"GB/s\":%.4f}}",
+                        e->label, ts_us, e->value);
+            }
+        }
+    }
+    fprintf(f, "\n]}\n");
+    int failed = ferror(f);
+    if (fclose(f) != 0) failed = 1;
+    if (dropped || trace_out_of_range) {
+        fprintf(stderr, "Trace: %zu events overwritten by full rings, %zu from workers past slot %d\n",
+                dropped, trace_out_of_range, trace_slots - 1);
+    }
+    return failed ? -1 : 0;
+}
+
+// Results kept for the HTML report (--report) and the results history
+// (--history). The display functions and threaded suites record through
+// record_latency/record_bandwidth, which also feed the trace counter tracks.
+// main sets the suite to the option it is about to run, and suites that
+// repeat a label over several shapes or sizes set record_case, which is
+// appended to the label, so history ids do not depend on which other suites
+// ran or which cases were skipped.
+typedef struct {
+    const char* suite;            // Suite option, "baseline" for the default tests
+    char label[REPORT_LABEL_CHARS];
+    size_t size;                  // Buffer size (latency results)
+    double value;                 // ns/access or GB/s
+} report_result_t;
+
+typedef struct {
+    report_result_t* items;
+    int count;
+    int capacity;
+} report_series_t;
+
+static int report_enabled;
+static const char* record_suite = "baseline";
+static char record_case[32];  // e.g. "2048x2048", empty for none
+static report_series_t report_latency;
+static report_series_t report_bandwidth;
+
+static void report_append(report_series_t* series, const char* label, size_t size, double value) {
+    if (series->count == series->capacity) {
+        int capacity = series->capacity ? series->capacity * 2 : 64;
+        report_result_t* items = realloc(series->items, capacity * sizeof(report_result_t));
+        if (!items) return;
+        series->items = items;
+        series->capacity = capacity;
+    }
+    report_result_t* r = &series->items[series->count++];
+    r->suite = record_suite;
+    if (record_case[0]) snprintf(r->label, sizeof(r->label), "%s %s", label, record_case);
+    else snprintf(r->label, sizeof(r->label), "%s", label);
+    r->size = size;
+    r->value = value;
+}
+
+// Start recording results for `suite`, with no case
+void record_set_suite(const char* suite) {
+    record_suite = suite;
+    record_case[0] = '\0';
+}
+
+void record_latency(const char* label, size_t buffer_size, double latency_ns) {
+    if (report_enabled) report_append(&report_latency, label, buffer_size, latency_ns);
+}
+
+void record_bandwidth(const char* label, double gbps) {
+    trace_counter(label, gbps);
+    if (report_enabled) report_append(&report_bandwidth, label, 0, gbps);
+}
+
+// Per-thread context handed to multithreaded kernels
+typedef struct {
+    int thread_id;
+    int num_threads;
+    void* shared;                 // Test parameters shared by all threads
+    pthread_barrier_t* barrier;
+    double start_time;
+    double end_time;
+    uint64_t sink;                // Kernel result, kept to prevent dead code elimination
+    int failed;                   // Set by workers whose setup failed (they still hit the barriers)
+    pthread_t handle;
+    const char* phase;            // Trace span in progress and when it started
+    double phase_start;
+} thread_ctx_t;
+
+// Close the worker's current trace span at `now` and open `next` (NULL: none)
+void thread_trace_phase(thread_ctx_t* ctx, const char* next, double now) {
+    if (!trace_rings) return;
+    if (ctx->phase) trace_span(ctx->thread_id, ctx->phase, ctx->phase_start, now);
+    ctx->phase = next;
+    ctx->phase_start = now;
+}
+
+// Mark untimed work such as warmup passes in the trace
+void thread_trace_mark(thread_ctx_t* ctx, const char* phase) {
+    if (trace_rings) thread_trace_phase(ctx, phase, get_time());
+}
+
+typedef void (*thread_worker_fn)(thread_ctx_t* ctx);
+
+typedef struct {
+    thread_ctx_t* ctx;
+    thread_worker_fn worker;
+} thread_start_t;
+
+// Synchronize all workers and start the timed section
+void thread_timed_begin(thread_ctx_t* ctx) {
+    thread_trace_mark(ctx, "barrier");
+    pthread_barrier_wait(ctx->barrier);
+    // Record the span before reading the start time so the write is not timed
+    if (trace_rings) thread_trace_phase(ctx, "sample", get_time());
+    ctx->start_time = get_time();
+}
+
+// Stop the timed section and wait for the slowest worker
+void thread_timed_end(thread_ctx_t* ctx) {
+    ctx->end_time = get_time();
+    thread_trace_phase(ctx, "barrier", ctx->end_time);
+    pthread_barrier_wait(ctx->barrier);
+    thread_trace_mark(ctx, "untimed");
+}
+
+void* thread_entry(void* arg) {
+    thread_start_t* start = (thread_start_t*)arg;
+    thread_trace_mark(start->ctx, "setup");
+    start->worker(start->ctx);
+    thread_trace_mark(start->ctx, NULL);
+    return NULL;
+}
+
+// Run a worker on num_threads threads. Each worker does its own setup and
+// brackets the measured part with thread_timed_begin/thread_timed_end.
+// Returns the wall time from the first start to the last end, or -1 on error.
+double run_threaded(int num_threads, thread_worker_fn worker, void* shared, uint64_t* sink) {
+    thread_ctx_t* ctx = calloc(num_threads, sizeof(thread_ctx_t));
+    thread_start_t* starts = calloc(num_threads, sizeof(thread_start_t));
+    pthread_barrier_t barrier;
+    
+    if (!ctx || !starts || pthread_barrier_init(&barrier, NULL, num_threads) != 0) {
+        fprintf(stderr, "Failed to set up %d worker threads\n", num_threads);
+        free(ctx);
+        free(starts);
+        return -1.0;
+    }
+    
+    int started = 0;
+    trace_run++;
+    for (int i = 0; i < num_threads; i++) {
+        ctx[i].thread_id = i;
+        ctx[i].num_threads = num_threads;
+        ctx[i].shared = shared;
+        ctx[i].barrier = &barrier;
+        starts[i].ctx = &ctx[i];
+        starts[i].worker = worker;
+        // Thread 0 runs on the calling thread so single-threaded runs stay in-process
+        if (i > 0) {
+            if (pthread_create(&ctx[i].handle, NULL, thread_entry, &starts[i]) != 0) {
+                fprintf(stderr, "Failed to create worker thread %d\n", i);
+                abort();  // Remaining workers would deadlock on the barrier
+            }
+            started++;
+        }
+    }
+    thread_entry(&starts[0]);
+    for (int i = 1; i <= started; i++) {
+        pthread_join(ctx[i].handle, NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+    
+    double first_start = ctx[0].start_time;
+    double last_end = ctx[0].end_time;
+    uint64_t combined = 0;
+    int failed = 0;
+    for (int i = 0; i < num_threads; i++) {
+        failed |= ctx[i].failed;
+        if (ctx[i].start_time < first_start) first_start = ctx[i].start_time;
+        if (ctx[i].end_time > last_end) last_end = ctx[i].end_time;
+        combined ^= ctx[i].sink;
+    }
+    if (sink) *sink = combined;
+    
+    free(ctx);
+    free(starts);
+    return failed ? -1.0 : last_end - first_start;
+}
+
+typedef struct {
+    const void* buffer;
+    size_t size;
+    int passes;
+} shared_read_args_t;
+
+// Each thread sums its own slice of one shared buffer
+void shared_read_worker(thread_ctx_t* ctx) {
+    shared_read_args_t* args = (shared_read_args_t*)ctx->shared;
+    size_t elements = args->size / sizeof(long long);
+    size_t begin = elements * ctx->thread_id / ctx->num_threads;
+    size_t end = elements * (ctx->thread_id + 1) / ctx->num_threads;
+    const long long* data = (const long long*)args->buffer;
+    long long sum = 0;
+    
+    thread_timed_begin(ctx);
+    for (int pass = 0; pass < args->passes; pass++) {
+        for (size_t i = begin; i < end; i++) {
+            sum += data[i];
+        }
+    }
+    thread_timed_end(ctx);
+    ctx->sink = (uint64_t)sum;
+}
+
+// Multithreaded sequential read over a shared buffer, split into equal slices
+double test_threaded_sequential_read(const void* buffer, size_t size, int iterations, int num_threads) {
+    shared_read_args_t args = {buffer, size, iterations};
+    return run_threaded(num_threads, shared_read_worker, &args, NULL);
+}
+
 // Sequential read test
 double test_sequential_read(void* buffer, size_t size, int iterations) {
     double start_time = get_time();
@@ -305,6 +840,24 @@ double test_random_write(void* buffer, size_t size, int iterations) {
     return end_time - start_time;
 }
 
+// Strided read test: one 8-byte load every `stride` bytes
+double test_strided_read(void* buffer, size_t size, size_t stride, int iterations) {
+    const char* data = (const char*)buffer;
+    double start_time = get_time();
+    volatile long long sum = 0;  // volatile to prevent optimization
+    
+    for (int iter = 0; iter < iterations; iter++) {
+        long long local = 0;
+        for (size_t offset = 0; offset + sizeof(long long) <= size; offset += stride) {
+            local += *(const long long*)(data + offset);
+        }
+        sum += local;
+    }
+    
+    double end_time = get_time();
+    return end_time - start_time;
+}
+
 // Memory copy test
 double test_memory_copy(void* src, void* dst, size_t size, int iterations) {
     double start_time = get_time();
@@ -317,15 +870,16 @@ double test_memory_copy(void* src, void* dst, size_t size, int iterations) {
     return end_time - start_time;
 }
 
-// True memory latency test using proper pointer chasing
-double test_memory_latency(void* buffer, size_t size, size_t num_accesses) {
+// Build a circular pointer chain through every cache line of the buffer in
+// random order and warm it up. Returns 0 if the buffer is too small.
+int build_pointer_chain(void* buffer, size_t size) {
     // Use cache line sized elements to avoid false sharing
     size_t cache_line_size = 64;  // bytes
     size_t elements = size / cache_line_size;
     char* data = (char*)buffer;
     
     if (elements < 2) {
-        return -1.0;  // Buffer too small
+        return 0;  // Buffer too small
     }
     
     // Create a circular linked list with random permutation
@@ -333,7 +887,7 @@ double test_memory_latency(void* buffer, size_t size, size_t num_accesses) {
     size_t* indices = malloc(elements * sizeof(size_t));
     if (!indices) {
         fprintf(stderr, "Failed to allocate indices for latency test\n");
-        return -1.0;
+        return 0;
     }
     
     // Initialize with sequential indices
@@ -375,6 +929,12 @@ double test_memory_latency(void* buffer, size_t size, size_t num_accesses) {
     
     // Another memory fence
     __sync_synchronize();
+    return 1;
+}
+
+// Time num_accesses dependent loads along a chain made by build_pointer_chain
+double chase_pointer_chain(void* buffer, size_t num_accesses) {
+    char* data = (char*)buffer;
     
     // Measure latency: time how long it takes to traverse the chain
     double start_time = get_time();
@@ -393,14 +953,24 @@ double test_memory_latency(void* buffer, size_t size, size_t num_accesses) {
         printf("Unexpected ptr value\n");
     }
     
+    return end_time - start_time;
+}
+
+// True memory latency test using proper pointer chasing
+double test_memory_latency(void* buffer, size_t size, size_t num_accesses) {
+    if (!build_pointer_chain(buffer, size)) {
+        return -1.0;
+    }
+    
+    double total_time = chase_pointer_chain(buffer, num_accesses);
+    
     // Debug: print timing info for troubleshooting
-    double total_time = end_time - start_time;
     if (total_time < 1e-6) {  // Less than 1 microsecond suggests timing issues
         fprintf(stderr, "Warning: Very short test time (%.9f s) for %zu accesses in %zu byte buffer\n", 
                 total_time, num_accesses, size);
     }
     
-    return end_time - start_time;
+    return total_time;
 }
 
 // Display latency results with cache level analysis
@@ -408,6 +978,7 @@ void display_latency(const char* test_name, double time_taken, size_t num_access
     double avg_latency_ns = (time_taken * 1e9) / num_accesses;
     double avg_latency_us = avg_latency_ns / 1000.0;
     const char* cache_level = analyze_cache_level(buffer_size, avg_latency_ns);
+    record_latency(test_name, buffer_size, avg_latency_ns);
     
     printf("%-12s (%6s): %8.1f ns/access (%6.2f us/access) - %-12s - %zu accesses\n", 
            test_name, 
@@ -548,6 +1119,7 @@ void display_bandwidth(const char* test_name, double time_taken, size_t data_siz
     double total_data_gb = (double)(data_size * iterations) / (1024.0 * 1024.0 * 1024.0);
     double bandwidth_gbps = total_data_gb / time_taken;
     double bandwidth_mbps = bandwidth_gbps * 1024.0;
+    record_bandwidth(test_name, bandwidth_gbps);
     
     printf("%-20s: %8.3f GB/s (%8.1f MB/s) - Time: %.3f seconds\n", 
            test_name, bandwidth_gbps, bandwidth_mbps, time_taken);
@@ -561,76 +1133,5803 @@ void display_random_bandwidth(const char* test_name, double time_taken, int iter
     double bandwidth_gbps = total_data_gb / time_taken;
     double bandwidth_mbps = bandwidth_gbps * 1024.0;
     double iops = (double)total_accesses / time_taken / 1000000.0; // Million operations per second
+    record_bandwidth(test_name, bandwidth_gbps);
     
     printf("%-20s: %8.3f GB/s (%8.1f MB/s) - %.1f MIOPS - Time: %.3f seconds\n", 
            test_name, bandwidth_gbps, bandwidth_mbps, iops, time_taken);
 }
 
-int main(int argc, char* argv[]) {
-    size_t size_mb = DEFAULT_SIZE_MB;
-    
-    // Parse command line arguments
-    if (argc > 1) {
-        size_mb = atoi(argv[1]);
-        if (size_mb == 0) {
-            fprintf(stderr, "Invalid size specified. Using default %d MB\n", DEFAULT_SIZE_MB);
-            size_mb = DEFAULT_SIZE_MB;
-        }
+// ---------------------------------------------------------------------------
+// Checksum and hash kernels fused with sequential reads
+// ---------------------------------------------------------------------------
+
+typedef uint64_t (*checksum_fn)(const void* data, size_t size);
+
+typedef struct {
+    const char* name;
+    checksum_fn fn;
+    int available;
+} checksum_kernel_t;
+
+// Same summing loop as test_sequential_read, used as the reference column
+uint64_t checksum_sequential_read(const void* data, size_t size) {
+    const uint64_t* words = (const uint64_t*)data;
+    size_t elements = size / sizeof(uint64_t);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < elements; i++) {
+        sum += words[i];
+    }
+    return sum;
+}
+
+#ifdef HAVE_X86_INTRINSICS
+// Hardware CRC32C (Castagnoli) using the SSE4.2 crc32 instruction, one dependency chain
+__attribute__((target("sse4.2")))
+uint32_t crc32c_hw_update(uint32_t crc, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t c = ~crc & 0xFFFFFFFFu;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        c = _mm_crc32_u64(c, word);
+    }
+    for (; i < size; i++) {
+        c = _mm_crc32_u8((uint32_t)c, bytes[i]);
+    }
+    return ~(uint32_t)c;
+}
+
+uint64_t checksum_crc32c_hw(const void* data, size_t size) {
+    return crc32c_hw_update(0, data, size);
+}
+
+// x^n mod P(x) for the CRC32C polynomial, bit-reflected for use as a fold constant
+uint64_t crc32c_fold_constant(unsigned int n) {
+    uint64_t r = 1;
+    for (unsigned int i = 0; i < n; i++) {
+        r <<= 1;
+        if (r & 0x100000000ULL) r ^= 0x11EDC6F41ULL;
+    }
+    uint32_t reflected = 0;
+    for (int i = 0; i < 32; i++) {
+        reflected = (reflected << 1) | ((r >> i) & 1);
+    }
+    return (uint64_t)reflected << 1;
+}
+
+// Fold constants for 512-bit and 128-bit distances, filled by crc32c_init_fold_constants()
+static uint64_t crc32c_fold_k[4];
+
+void crc32c_init_fold_constants(void) {
+    crc32c_fold_k[0] = crc32c_fold_constant(512 + 32);
+    crc32c_fold_k[1] = crc32c_fold_constant(512 - 32);
+    crc32c_fold_k[2] = crc32c_fold_constant(128 + 32);
+    crc32c_fold_k[3] = crc32c_fold_constant(128 - 32);
+}
+
+// CRC32C by carry-less multiplication: fold four 128-bit lanes across 64-byte
+// blocks with PCLMULQDQ, then reduce the final 128 bits with the crc32 instruction.
+__attribute__((target("sse4.2,pclmul")))
+uint32_t crc32c_clmul_update(uint32_t crc, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    if (size < 64) {
+        return crc32c_hw_update(crc, data, size);
     }
     
-    size_t buffer_size = MB_TO_BYTES(size_mb);
-    
-    printf("Memory Bandwidth Test\n");
-    printf("===========================\n");
-    printf("Buffer size: %zu MB (%zu bytes)\n", size_mb, buffer_size);
-    printf("Iterations: %d\n", ITERATIONS);
-    printf("Random accesses per iteration: %d\n", RANDOM_ACCESSES);
-    printf("CPU cores available: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
-    
-    // Read and display cache hierarchy information
-    read_cache_info();
-    display_cache_hierarchy();
+    const __m128i fold4 = _mm_set_epi64x((long long)crc32c_fold_k[1], (long long)crc32c_fold_k[0]);
+    const __m128i fold1 = _mm_set_epi64x((long long)crc32c_fold_k[3], (long long)crc32c_fold_k[2]);
     
-    // Initialize random number generator
-    init_random();
+    __m128i x0 = _mm_loadu_si128((const __m128i*)(bytes + 0));
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(bytes + 16));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(bytes + 32));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(bytes + 48));
+    x0 = _mm_xor_si128(x0, _mm_cvtsi32_si128((int)~crc));
     
-    // Allocate memory buffers
-    void* buffer1 = aligned_malloc(64, buffer_size);  // 64-byte aligned for cache efficiency
-    void* buffer2 = aligned_malloc(64, buffer_size);
+    size_t i = 64;
+    for (; i + 64 <= size; i += 64) {
+        __m128i lo0 = _mm_clmulepi64_si128(x0, fold4, 0x00);
+        __m128i lo1 = _mm_clmulepi64_si128(x1, fold4, 0x00);
+        __m128i lo2 = _mm_clmulepi64_si128(x2, fold4, 0x00);
+        __m128i lo3 = _mm_clmulepi64_si128(x3, fold4, 0x00);
+        __m128i hi0 = _mm_clmulepi64_si128(x0, fold4, 0x11);
+        __m128i hi1 = _mm_clmulepi64_si128(x1, fold4, 0x11);
+        __m128i hi2 = _mm_clmulepi64_si128(x2, fold4, 0x11);
+        __m128i hi3 = _mm_clmulepi64_si128(x3, fold4, 0x11);
+        x0 = _mm_xor_si128(_mm_xor_si128(lo0, hi0), _mm_loadu_si128((const __m128i*)(bytes + i + 0)));
+        x1 = _mm_xor_si128(_mm_xor_si128(lo1, hi1), _mm_loadu_si128((const __m128i*)(bytes + i + 16)));
+        x2 = _mm_xor_si128(_mm_xor_si128(lo2, hi2), _mm_loadu_si128((const __m128i*)(bytes + i + 32)));
+        x3 = _mm_xor_si128(_mm_xor_si128(lo3, hi3), _mm_loadu_si128((const __m128i*)(bytes + i + 48)));
+    }
     
-    if (!buffer1 || !buffer2) {
-        fprintf(stderr, "Failed to allocate memory buffers\n");
-        if (buffer1) free(buffer1);
-        if (buffer2) free(buffer2);
-        return 1;
+    // Fold the four lanes into one
+    __m128i lanes[3] = {x1, x2, x3};
+    for (int l = 0; l < 3; l++) {
+        __m128i lo = _mm_clmulepi64_si128(x0, fold1, 0x00);
+        __m128i hi = _mm_clmulepi64_si128(x0, fold1, 0x11);
+        x0 = _mm_xor_si128(_mm_xor_si128(lo, hi), lanes[l]);
     }
     
-    // Initialize buffers with data
-    printf("Initializing buffers...\n");
-    memset(buffer1, 0xAA, buffer_size);
-    memset(buffer2, 0x55, buffer_size);
+    uint64_t c = 0;
+    c = _mm_crc32_u64(c, (uint64_t)_mm_cvtsi128_si64(x0));
+    c = _mm_crc32_u64(c, (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(x0, x0)));
     
-    // Perform tests
-    printf("\nRunning bandwidth tests...\n");
-    printf("%-20s  %-50s\n", "Test", "Bandwidth");
-    printf("--------------------------------------------------------------------------------\n");
+    return crc32c_hw_update(~(uint32_t)c, bytes + i, size - i);
+}
+
+uint64_t checksum_crc32c_clmul(const void* data, size_t size) {
+    return crc32c_clmul_update(0, data, size);
+}
+#endif
+
+// 64-bit non-cryptographic hash following the xxHash64 construction
+#define HASH64_PRIME1 0x9E3779B185EBCA87ULL
+#define HASH64_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define HASH64_PRIME3 0x165667B19E3779F9ULL
+#define HASH64_PRIME4 0x85EBCA77C2B2AE63ULL
+#define HASH64_PRIME5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t hash64_rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t hash64_round(uint64_t acc, uint64_t input) {
+    acc += input * HASH64_PRIME2;
+    acc = hash64_rotl(acc, 31);
+    return acc * HASH64_PRIME1;
+}
+
+static inline uint64_t hash64_merge(uint64_t acc, uint64_t val) {
+    acc ^= hash64_round(0, val);
+    return acc * HASH64_PRIME1 + HASH64_PRIME4;
+}
+
+uint64_t checksum_hash64(const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    const unsigned char* end = p + size;
+    const uint64_t seed = 0;
+    uint64_t h;
     
-    // Sequential tests
-    double read_time = test_sequential_read(buffer1, buffer_size, ITERATIONS);
-    display_bandwidth("Sequential Read", read_time, buffer_size, ITERATIONS);
+    if (size >= 32) {
+        uint64_t v1 = seed + HASH64_PRIME1 + HASH64_PRIME2;
+        uint64_t v2 = seed + HASH64_PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - HASH64_PRIME1;
+        const unsigned char* limit = end - 32;
+        do {
+            uint64_t w[4];
+            memcpy(w, p, sizeof(w));
+            v1 = hash64_round(v1, w[0]);
+            v2 = hash64_round(v2, w[1]);
+            v3 = hash64_round(v3, w[2]);
+            v4 = hash64_round(v4, w[3]);
+            p += 32;
+        } while (p <= limit);
+        h = hash64_rotl(v1, 1) + hash64_rotl(v2, 7) + hash64_rotl(v3, 12) + hash64_rotl(v4, 18);
+        h = hash64_merge(h, v1);
+        h = hash64_merge(h, v2);
+        h = hash64_merge(h, v3);
+        h = hash64_merge(h, v4);
+    } else {
+        h = seed + HASH64_PRIME5;
+    }
+    h += (uint64_t)size;
     
-    double write_time = test_sequential_write(buffer1, buffer_size, ITERATIONS);
-    display_bandwidth("Sequential Write", write_time, buffer_size, ITERATIONS);
+    for (; p + 8 <= end; p += 8) {
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+        h ^= hash64_round(0, w);
+        h = hash64_rotl(h, 27) * HASH64_PRIME1 + HASH64_PRIME4;
+    }
+    if (p + 4 <= end) {
+        uint32_t w;
+        memcpy(&w, p, sizeof(w));
+        h ^= (uint64_t)w * HASH64_PRIME1;
+        h = hash64_rotl(h, 23) * HASH64_PRIME2 + HASH64_PRIME3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        h ^= (*p) * HASH64_PRIME5;
+        h = hash64_rotl(h, 11) * HASH64_PRIME1;
+    }
     
-    // Random tests
-    double random_read_time = test_random_read(buffer1, buffer_size, ITERATIONS);
-    if (random_read_time > 0) {
-        display_random_bandwidth("Random Read", random_read_time, ITERATIONS);
+    h ^= h >> 33;
+    h *= HASH64_PRIME2;
+    h ^= h >> 29;
+    h *= HASH64_PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+// Build the kernel table, enabling instruction-set specific kernels only when supported
+int get_checksum_kernels(checksum_kernel_t* kernels) {
+    int count = 0;
+    kernels[count++] = (checksum_kernel_t){"Seq Read", checksum_sequential_read, 1};
+#ifdef HAVE_X86_INTRINSICS
+    __builtin_cpu_init();
+    crc32c_init_fold_constants();
+    int have_sse42 = __builtin_cpu_supports("sse4.2");
+    int have_clmul = have_sse42 && __builtin_cpu_supports("pclmul");
+    kernels[count++] = (checksum_kernel_t){"CRC32C HW", checksum_crc32c_hw, have_sse42};
+    kernels[count++] = (checksum_kernel_t){"CRC32C CLMUL", checksum_crc32c_clmul, have_clmul};
+#else
+    kernels[count++] = (checksum_kernel_t){"CRC32C HW", NULL, 0};
+    kernels[count++] = (checksum_kernel_t){"CRC32C CLMUL", NULL, 0};
+#endif
+    kernels[count++] = (checksum_kernel_t){"Hash64", checksum_hash64, 1};
+    return count;
+}
+
+// Check that the folded CLMUL CRC agrees with the crc32 instruction
+int checksum_self_test(void) {
+#ifdef HAVE_X86_INTRINSICS
+    if (!__builtin_cpu_supports("sse4.2") || !__builtin_cpu_supports("pclmul")) {
+        return 1;
+    }
+    if (crc32c_hw_update(0, "123456789", 9) != 0xE3069283u) {
+        return 0;
+    }
+    unsigned char sample[1024];
+    for (size_t i = 0; i < sizeof(sample); i++) {
+        sample[i] = (unsigned char)(i * 131 + 7);
+    }
+    for (size_t len = 0; len <= sizeof(sample); len += 13) {
+        if (crc32c_hw_update(0, sample, len) != crc32c_clmul_update(0, sample, len)) {
+            return 0;
+        }
     }
+#endif
+    return 1;
+}
+
+typedef struct {
+    size_t size;
+    checksum_fn fn;
+    int passes;
+} checksum_args_t;
+
+// Each thread hashes its own buffer so the working set per core matches the size under test
+void checksum_worker(thread_ctx_t* ctx) {
+    checksum_args_t* args = (checksum_args_t*)ctx->shared;
+    void* buffer = aligned_malloc(64, args->size);
+    uint64_t result = 0;
     
-    double random_write_time = test_random_write(buffer1, buffer_size, ITERATIONS);
-    if (random_write_time > 0) {
-        display_random_bandwidth("Random Write", random_write_time, ITERATIONS);
+    if (buffer) {
+        memset(buffer, 0xA5 ^ ctx->thread_id, args->size);
+        thread_trace_mark(ctx, "warmup");
+        result ^= args->fn(buffer, args->size);  // Warmup pass
+    } else {
+        ctx->failed = 1;
+    }
+    
+    thread_timed_begin(ctx);
+    if (buffer) {
+        for (int pass = 0; pass < args->passes; pass++) {
+            result ^= args->fn(buffer, args->size);
+        }
+    }
+    thread_timed_end(ctx);
+    
+    ctx->sink = result;
+    free(buffer);
+}
+
+// Run every checksum kernel at each test size and print GB/s side by side
+void run_checksum_tests(int num_threads) {
+    checksum_kernel_t kernels[8];
+    int num_kernels = get_checksum_kernels(kernels);
+    
+    printf("\nRunning checksum throughput tests (%d thread%s, private buffer per thread)...\n",
+           num_threads, num_threads == 1 ? "" : "s");
+    if (!checksum_self_test()) {
+        printf("Warning: CLMUL CRC32C does not match the crc32 instruction; results are suspect\n");
+    }
+    printf("%-12s", "Buffer Size");
+    for (int k = 0; k < num_kernels; k++) {
+        printf(" %12s", kernels[k].name);
+    }
+    printf("   (GB/s)\n");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    size_t* test_sizes;
+    char** size_names;
+    int num_tests;
+    generate_dynamic_test_sizes(&test_sizes, &size_names, &num_tests);
+    
+    for (int i = 0; i < num_tests; i++) {
+        size_t size = test_sizes[i];
+        int passes = (int)(CHECKSUM_TARGET_BYTES / size);
+        if (passes < ITERATIONS) passes = ITERATIONS;
+        
+        printf("%-12s", size_names[i]);
+        fflush(stdout);
+        for (int k = 0; k < num_kernels; k++) {
+            if (!kernels[k].available) {
+                printf(" %12s", "n/a");
+                continue;
+            }
+            checksum_args_t args = {size, kernels[k].fn, passes};
+            uint64_t sink;
+            double elapsed = run_threaded(num_threads, checksum_worker, &args, &sink);
+            if (elapsed <= 0) {
+                printf(" %12s", "failed");
+                continue;
+            }
+            double total_gb = (double)size * passes * num_threads / (1024.0 * 1024.0 * 1024.0);
+            char label[REPORT_LABEL_CHARS];
+            snprintf(label, sizeof(label), "%s %s", kernels[k].name, size_names[i]);
+            record_bandwidth(label, total_gb / elapsed);
+            printf(" %12.3f", total_gb / elapsed);
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+    
+    free_dynamic_test_sizes(test_sizes, size_names, num_tests);
+}
+
+void print_usage(const char* program) {
+    printf("Usage: %s [size_mb] [options]\n", program);
+    printf("  size_mb          Buffer size for bandwidth tests (default: %d)\n", DEFAULT_SIZE_MB);
+    printf("  --threads N      Worker threads for multithreaded tests (default: online CPUs)\n");
+    printf("  --checksum       CRC32C (SSE4.2 and CLMUL) and Hash64 throughput per buffer size\n");
+    printf("  --strings        memchr/strlen/memcmp bandwidth, libc versus in-tree SSE2/AVX2\n");
+    printf("  --spmv           CSR sparse matrix-vector multiply on banded/power-law/uniform matrices\n");
+    printf("  --graph          BFS (top-down, bottom-up) and PageRank on uniform and R-MAT graphs\n");
+    printf("  --transpose      Naive, blocked, cache-oblivious and SIMD matrix transpose\n");
+    printf("  --stencil        2D 5-point and 3D 7-point stencils with spatial and temporal tiling\n");
+    printf("  --pollution      Victim latency while another core streams with loads, NTA or NT stores\n");
+    printf("  --prefetch       Software prefetch hints (T0/T1/T2/NTA/W) with a cache residency probe\n");
+    printf("  --hw-prefetch    Rerun core suites with hardware prefetchers disabled via MSR (root)\n");
+    printf("  --inclusivity    Classify the LLC as inclusive/non-inclusive/exclusive before latency tests\n");
+    printf("  --replacement    Cyclic, reverse and scan patterns per cache set against an LRU model\n");
+    printf("  --coherence      Latency of reading lines another core holds Modified, Exclusive or Shared\n");
+    printf("  --dram           DRAM row hit/miss latency and bank-level parallelism in a 2 MB hugepage\n");
+    printf("  --page-color     Latency/bandwidth variance of page-colored versus uncolored buffers (root)\n");
+    printf("  --trace          Timestamped chase trace with periodic stall detection (refresh, ticks, SMIs)\n");
+    printf("  --numa           Bind, interleave and weighted interleave on every memory node, CPU-less included\n");
+    printf("  --migrate        Page migration cost (move_pages, mbind MPOL_MF_MOVE) for 4 KB and 2 MB pages\n");
+    printf("  --autonuma       Remote-placed memory under kernel NUMA balancing: convergence and fault cost\n");
+    printf("  --aging          Allocation churn, then RSS, hugepage availability and live-object traversal\n");
+    printf("  --aging-seconds N  Churn duration for --aging (default: %d)\n", AGING_SECONDS);
+    printf("  --openmp         Sequential, STREAM and random kernels on OpenMP next to pthreads (OpenMP build)\n");
+    printf("  --trace-json F   Write a Chrome/Perfetto trace of worker threads and bandwidth counters to F\n");
+    printf("  --report F       Run a thread-scaling sweep and write an HTML/SVG report of the run to F\n");
+    printf("  --history F      Append this run's results to the JSONL history F, keyed by host fingerprint\n");
+    printf("  --history-query F  Trend, drift and change points per metric for this host, then exit\n");
+    printf("  --since DATE     Drift reference day for --history-query (YYYY-MM-DD, default: first run)\n");
+    printf("  --help           Show this message\n");
+}
+
+// ---------------------------------------------------------------------------
+// String primitive kernels: libc versus in-tree SSE2/AVX2
+// ---------------------------------------------------------------------------
+
+typedef enum { STRING_MEMCHR, STRING_STRLEN, STRING_MEMCMP } string_op_t;
+
+typedef struct {
+    const char* name;
+    string_op_t op;
+    const void* (*memchr_fn)(const void* s, int c, size_t n);
+    size_t (*strlen_fn)(const char* s);
+    int (*memcmp_fn)(const void* a, const void* b, size_t n);
+    int available;
+} string_kernel_t;
+
+const void* string_memchr_libc(const void* s, int c, size_t n) {
+    return memchr(s, c, n);
+}
+
+size_t string_strlen_libc(const char* s) {
+    return strlen(s);
+}
+
+int string_memcmp_libc(const void* a, const void* b, size_t n) {
+    return memcmp(a, b, n);
+}
+
+#ifdef HAVE_X86_INTRINSICS
+// Combine four 16-byte compare masks into one 64-bit mask
+static inline uint64_t sse2_mask64(__m128i m0, __m128i m1, __m128i m2, __m128i m3) {
+    return (uint64_t)(uint16_t)_mm_movemask_epi8(m0) |
+           ((uint64_t)(uint16_t)_mm_movemask_epi8(m1) << 16) |
+           ((uint64_t)(uint16_t)_mm_movemask_epi8(m2) << 32) |
+           ((uint64_t)(uint16_t)_mm_movemask_epi8(m3) << 48);
+}
+
+const void* string_memchr_sse2(const void* s, int c, size_t n) {
+    const unsigned char* p = (const unsigned char*)s;
+    const __m128i needle = _mm_set1_epi8((char)c);
+    size_t i = 0;
+    
+    for (; i + 64 <= n; i += 64) {
+        __m128i m0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + i)), needle);
+        __m128i m1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + i + 16)), needle);
+        __m128i m2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + i + 32)), needle);
+        __m128i m3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + i + 48)), needle);
+        __m128i any = _mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3));
+        if (_mm_movemask_epi8(any)) {
+            return p + i + __builtin_ctzll(sse2_mask64(m0, m1, m2, m3));
+        }
+    }
+    for (; i + 16 <= n; i += 16) {
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + i)), needle));
+        if (mask) return p + i + __builtin_ctz(mask);
+    }
+    for (; i < n; i++) {
+        if (p[i] == (unsigned char)c) return p + i;
+    }
+    return NULL;
+}
+
+// Aligned 64-byte blocks never cross a page, so reading before s is safe
+size_t string_strlen_sse2(const char* s) {
+    const __m128i zero = _mm_setzero_si128();
+    uintptr_t offset = (uintptr_t)s & 63;
+    const char* block = s - offset;
+    
+    for (;;) {
+        __m128i v0 = _mm_load_si128((const __m128i*)(block + 0));
+        __m128i v1 = _mm_load_si128((const __m128i*)(block + 16));
+        __m128i v2 = _mm_load_si128((const __m128i*)(block + 32));
+        __m128i v3 = _mm_load_si128((const __m128i*)(block + 48));
+        // Unsigned byte minimum is zero only if some byte in the block is zero
+        __m128i low = _mm_min_epu8(_mm_min_epu8(v0, v1), _mm_min_epu8(v2, v3));
+        if (offset || _mm_movemask_epi8(_mm_cmpeq_epi8(low, zero))) {
+            uint64_t mask = sse2_mask64(_mm_cmpeq_epi8(v0, zero), _mm_cmpeq_epi8(v1, zero),
+                                        _mm_cmpeq_epi8(v2, zero), _mm_cmpeq_epi8(v3, zero)) >> offset;
+            if (mask) {
+                return (size_t)(block + offset - s) + __builtin_ctzll(mask);
+            }
+        }
+        block += 64;
+        offset = 0;
+    }
+}
+
+int string_memcmp_sse2(const void* a, const void* b, size_t n) {
+    const unsigned char* pa = (const unsigned char*)a;
+    const unsigned char* pb = (const unsigned char*)b;
+    size_t i = 0;
+    
+    for (; i + 64 <= n; i += 64) {
+        __m128i e0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(pa + i)), _mm_loadu_si128((const __m128i*)(pb + i)));
+        __m128i e1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(pa + i + 16)), _mm_loadu_si128((const __m128i*)(pb + i + 16)));
+        __m128i e2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(pa + i + 32)), _mm_loadu_si128((const __m128i*)(pb + i + 32)));
+        __m128i e3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(pa + i + 48)), _mm_loadu_si128((const __m128i*)(pb + i + 48)));
+        __m128i all = _mm_and_si128(_mm_and_si128(e0, e1), _mm_and_si128(e2, e3));
+        if (_mm_movemask_epi8(all) != 0xFFFF) {
+            size_t d = i + __builtin_ctzll(~sse2_mask64(e0, e1, e2, e3));
+            return (int)pa[d] - (int)pb[d];
+        }
+    }
+    for (; i < n; i++) {
+        if (pa[i] != pb[i]) return (int)pa[i] - (int)pb[i];
+    }
+    return 0;
+}
+
+__attribute__((target("avx2")))
+const void* string_memchr_avx2(const void* s, int c, size_t n) {
+    const unsigned char* p = (const unsigned char*)s;
+    const __m256i needle = _mm256_set1_epi8((char)c);
+    size_t i = 0;
+    
+    for (; i + 128 <= n; i += 128) {
+        __m256i m0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i)), needle);
+        __m256i m1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i + 32)), needle);
+        __m256i m2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i + 64)), needle);
+        __m256i m3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i + 96)), needle);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(m0, m1), _mm256_or_si256(m2, m3));
+        if (_mm256_movemask_epi8(any)) {
+            uint64_t lo = (uint32_t)_mm256_movemask_epi8(m0) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(m1) << 32);
+            if (lo) return p + i + __builtin_ctzll(lo);
+            uint64_t hi = (uint32_t)_mm256_movemask_epi8(m2) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(m3) << 32);
+            return p + i + 64 + __builtin_ctzll(hi);
+        }
+    }
+    for (; i + 32 <= n; i += 32) {
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i)), needle));
+        if (mask) return p + i + __builtin_ctz(mask);
+    }
+    for (; i < n; i++) {
+        if (p[i] == (unsigned char)c) return p + i;
+    }
+    return NULL;
+}
+
+__attribute__((target("avx2")))
+size_t string_strlen_avx2(const char* s) {
+    const __m256i zero = _mm256_setzero_si256();
+    uintptr_t offset = (uintptr_t)s & 63;
+    const char* block = s - offset;
+    
+    for (;;) {
+        __m256i v0 = _mm256_load_si256((const __m256i*)(block + 0));
+        __m256i v1 = _mm256_load_si256((const __m256i*)(block + 32));
+        __m256i low = _mm256_min_epu8(v0, v1);
+        if (offset || _mm256_movemask_epi8(_mm256_cmpeq_epi8(low, zero))) {
+            uint64_t mask = ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v0, zero)) |
+                             ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v1, zero)) << 32)) >> offset;
+            if (mask) {
+                return (size_t)(block + offset - s) + __builtin_ctzll(mask);
+            }
+        }
+        block += 64;
+        offset = 0;
+    }
+}
+
+__attribute__((target("avx2")))
+int string_memcmp_avx2(const void* a, const void* b, size_t n) {
+    const unsigned char* pa = (const unsigned char*)a;
+    const unsigned char* pb = (const unsigned char*)b;
+    size_t i = 0;
+    
+    for (; i + 64 <= n; i += 64) {
+        __m256i e0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(pa + i)), _mm256_loadu_si256((const __m256i*)(pb + i)));
+        __m256i e1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(pa + i + 32)), _mm256_loadu_si256((const __m256i*)(pb + i + 32)));
+        uint64_t equal = (uint64_t)(uint32_t)_mm256_movemask_epi8(e0) |
+                         ((uint64_t)(uint32_t)_mm256_movemask_epi8(e1) << 32);
+        if (equal != UINT64_MAX) {
+            size_t d = i + __builtin_ctzll(~equal);
+            return (int)pa[d] - (int)pb[d];
+        }
+    }
+    for (; i < n; i++) {
+        if (pa[i] != pb[i]) return (int)pa[i] - (int)pb[i];
+    }
+    return 0;
+}
+#endif
+
+int get_string_kernels(string_kernel_t* kernels) {
+    int count = 0;
+    int have_sse2 = 0, have_avx2 = 0;
+#ifdef HAVE_X86_INTRINSICS
+    __builtin_cpu_init();
+    have_sse2 = 1;  // Baseline on x86-64
+    have_avx2 = __builtin_cpu_supports("avx2");
+#endif
+    kernels[count++] = (string_kernel_t){"memchr libc", STRING_MEMCHR, string_memchr_libc, NULL, NULL, 1};
+    kernels[count++] = (string_kernel_t){"strlen libc", STRING_STRLEN, NULL, string_strlen_libc, NULL, 1};
+    kernels[count++] = (string_kernel_t){"memcmp libc", STRING_MEMCMP, NULL, NULL, string_memcmp_libc, 1};
+#ifdef HAVE_X86_INTRINSICS
+    kernels[count++] = (string_kernel_t){"memchr SSE2", STRING_MEMCHR, string_memchr_sse2, NULL, NULL, have_sse2};
+    kernels[count++] = (string_kernel_t){"strlen SSE2", STRING_STRLEN, NULL, string_strlen_sse2, NULL, have_sse2};
+    kernels[count++] = (string_kernel_t){"memcmp SSE2", STRING_MEMCMP, NULL, NULL, string_memcmp_sse2, have_sse2};
+    kernels[count++] = (string_kernel_t){"memchr AVX2", STRING_MEMCHR, string_memchr_avx2, NULL, NULL, have_avx2};
+    kernels[count++] = (string_kernel_t){"strlen AVX2", STRING_STRLEN, NULL, string_strlen_avx2, NULL, have_avx2};
+    kernels[count++] = (string_kernel_t){"memcmp AVX2", STRING_MEMCMP, NULL, NULL, string_memcmp_avx2, have_avx2};
+#else
+    (void)have_sse2;
+    (void)have_avx2;
+#endif
+    return count;
+}
+
+// Time one string primitive that stops at byte `position` of a buffer starting
+// at `offset` bytes past a 64-byte boundary. Returns seconds for `passes` calls.
+double test_string_kernel(const string_kernel_t* kernel, unsigned char* a, unsigned char* b,
+                          size_t length, size_t position, int passes) {
+    volatile size_t sink = 0;
+    
+    // Haystack of 'a' with the match, terminator or first difference at `position`
+    memset(a, 'a', length);
+    memcpy(b, a, length);
+    switch (kernel->op) {
+    case STRING_MEMCHR: a[position] = 'x'; break;
+    case STRING_STRLEN: a[position] = '\0'; break;
+    case STRING_MEMCMP: b[position] = 'b'; break;
+    }
+    
+    double start_time = get_time();
+    for (int pass = 0; pass < passes; pass++) {
+        switch (kernel->op) {
+        case STRING_MEMCHR:
+            sink += (size_t)((const unsigned char*)kernel->memchr_fn(a, 'x', length) - a);
+            break;
+        case STRING_STRLEN:
+            sink += kernel->strlen_fn((const char*)a);
+            break;
+        case STRING_MEMCMP:
+            sink += kernel->memcmp_fn(a, b, length) < 0;  // Only the sign is specified
+            break;
+        }
+    }
+    double end_time = get_time();
+    
+    if (sink != (size_t)passes * (kernel->op == STRING_MEMCMP ? 1 : position)) {
+        fprintf(stderr, "Warning: %s returned an unexpected result\n", kernel->name);
+    }
+    return end_time - start_time;
+}
+
+// Run each kernel for one buffer configuration and print it in display_bandwidth format
+void run_string_case(string_kernel_t* kernels, int num_kernels, size_t length,
+                     size_t position, size_t offset, const char* label) {
+    // Both buffers share the same misalignment; strlen never reads past the aligned block holding the NUL
+    unsigned char* base_a = aligned_malloc(64, length + 128);
+    unsigned char* base_b = aligned_malloc(64, length + 128);
+    if (!base_a || !base_b) {
+        fprintf(stderr, "Failed to allocate %zu byte string buffers\n", length);
+        free(base_a);
+        free(base_b);
+        return;
+    }
+    
+    size_t scanned = position + 1;
+    int passes = (int)(STRING_TARGET_BYTES / scanned);
+    if (passes < ITERATIONS) passes = ITERATIONS;
+    
+    printf("%s\n", label);
+    // Case: buffer size, match position and start offset
+    char size_str[24];
+    if (length >= MB_TO_BYTES(1)) snprintf(size_str, sizeof(size_str), "%zuMB", length / (1024 * 1024));
+    else snprintf(size_str, sizeof(size_str), "%zuKB", length / 1024);
+    if (position + 1 == length) {
+        snprintf(record_case, sizeof(record_case), "%s end +%zu", size_str, offset);
+    } else {
+        snprintf(record_case, sizeof(record_case), "%s %zu%% +%zu", size_str, position * 100 / length, offset);
+    }
+    for (int k = 0; k < num_kernels; k++) {
+        if (!kernels[k].available) continue;
+        double elapsed = test_string_kernel(&kernels[k], base_a + offset, base_b + offset,
+                                            length, position, passes);
+        // memcmp reads both inputs
+        size_t bytes = kernels[k].op == STRING_MEMCMP ? scanned * 2 : scanned;
+        display_bandwidth(kernels[k].name, elapsed, bytes, passes);
+    }
+    record_case[0] = '\0';
+    
+    free(base_a);
+    free(base_b);
+}
+
+void run_string_tests(void) {
+    string_kernel_t kernels[12];
+    int num_kernels = get_string_kernels(kernels);
+    char label[96];
+    
+    printf("\nRunning string primitive bandwidth tests...\n");
+    printf("%-20s  %-50s\n", "Test", "Bandwidth");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    size_t* test_sizes;
+    char** size_names;
+    int num_tests;
+    generate_dynamic_test_sizes(&test_sizes, &size_names, &num_tests);
+    
+    // Size sweep: match at the last byte, 64-byte aligned. Sizes just past a
+    // level are skipped to keep the table short.
+    size_t mid_size = 0;
+    for (int i = 0; i < num_tests; i++) {
+        if (strchr(size_names[i], '>')) continue;
+        if (strstr(size_names[i], "RAM") && i + 1 < num_tests) continue;  // Keep only the largest RAM size
+        snprintf(label, sizeof(label), "[%s, match at end, aligned]", size_names[i]);
+        run_string_case(kernels, num_kernels, test_sizes[i], test_sizes[i] - 1, 0, label);
+        if (!mid_size && strstr(size_names[i], "(L")) mid_size = test_sizes[i];
+    }
+    if (!mid_size) mid_size = KB_TO_BYTES(16);
+    
+    // Match position sweep at the first cache-resident size
+    const int positions[] = {25, 50};
+    for (int p = 0; p < 2; p++) {
+        snprintf(label, sizeof(label), "[%zuKB, match at %d%%, aligned]", mid_size / 1024, positions[p]);
+        run_string_case(kernels, num_kernels, mid_size, mid_size * positions[p] / 100, 0, label);
+    }
+    
+    // Misaligned start addresses
+    const size_t offsets[] = {1, 33};
+    for (int o = 0; o < 2; o++) {
+        snprintf(label, sizeof(label), "[%zuKB, match at end, offset +%zu]", mid_size / 1024, offsets[o]);
+        run_string_case(kernels, num_kernels, mid_size, mid_size - 1, offsets[o], label);
+    }
+    
+    free_dynamic_test_sizes(test_sizes, size_names, num_tests);
+}
+
+// ---------------------------------------------------------------------------
+// Sparse matrix-vector multiply (CSR)
+// ---------------------------------------------------------------------------
+
+typedef enum { MATRIX_BANDED, MATRIX_POWER_LAW, MATRIX_UNIFORM } matrix_kind_t;
+
+typedef struct {
+    size_t rows;
+    size_t cols;
+    size_t nnz;
+    size_t* row_ptr;     // rows + 1 entries
+    uint32_t* col_idx;   // nnz entries
+    double* values;      // nnz entries
+} csr_matrix_t;
+
+const char* matrix_kind_name(matrix_kind_t kind) {
+    switch (kind) {
+    case MATRIX_BANDED: return "banded";
+    case MATRIX_POWER_LAW: return "power-law";
+    case MATRIX_UNIFORM: return "uniform";
+    }
+    return "unknown";
+}
+
+int compare_uint32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+void free_csr_matrix(csr_matrix_t* m) {
+    free(m->row_ptr);
+    free(m->col_idx);
+    free(m->values);
+    memset(m, 0, sizeof(*m));
+}
+
+// Generate a square matrix with about SPMV_NNZ_PER_ROW non-zeros per row.
+// Banded keeps columns near the diagonal, uniform scatters them, and power-law
+// skews both row lengths and column popularity like embedding-table lookups.
+int generate_csr_matrix(csr_matrix_t* m, matrix_kind_t kind, size_t rows) {
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ (uint64_t)kind;
+    memset(m, 0, sizeof(*m));
+    m->rows = rows;
+    m->cols = rows;
+    m->row_ptr = malloc((rows + 1) * sizeof(size_t));
+    if (!m->row_ptr) return 0;
+    
+    // Row lengths first so the index arrays can be allocated exactly
+    m->row_ptr[0] = 0;
+    for (size_t r = 0; r < rows; r++) {
+        size_t len = SPMV_NNZ_PER_ROW;
+        if (kind == MATRIX_POWER_LAW) {
+            // Pareto tail with mean SPMV_NNZ_PER_ROW
+            double u = 1.0 - xorshift64_unit(&rng);
+            len = (size_t)(SPMV_NNZ_PER_ROW * 0.5 / sqrt(u));
+            if (len < 1) len = 1;
+            if (len > rows) len = rows;
+        }
+        m->row_ptr[r + 1] = m->row_ptr[r] + len;
+    }
+    m->nnz = m->row_ptr[rows];
+    m->col_idx = aligned_malloc(64, m->nnz * sizeof(uint32_t));
+    m->values = aligned_malloc(64, m->nnz * sizeof(double));
+    if (!m->col_idx || !m->values) {
+        free_csr_matrix(m);
+        return 0;
+    }
+    
+    size_t band = SPMV_NNZ_PER_ROW * 8;
+    for (size_t r = 0; r < rows; r++) {
+        size_t begin = m->row_ptr[r];
+        size_t len = m->row_ptr[r + 1] - begin;
+        for (size_t k = 0; k < len; k++) {
+            size_t col;
+            switch (kind) {
+            case MATRIX_BANDED: {
+                size_t lo = r > band / 2 ? r - band / 2 : 0;
+                col = lo + xorshift64(&rng) % band;
+                if (col >= rows) col = rows - 1 - xorshift64(&rng) % band;
+                break;
+            }
+            case MATRIX_POWER_LAW: {
+                // Cubing a uniform sample concentrates columns on a small hot set
+                double u = xorshift64_unit(&rng);
+                col = (size_t)(u * u * u * rows);
+                break;
+            }
+            default:
+                col = xorshift64(&rng) % rows;
+                break;
+            }
+            m->col_idx[begin + k] = (uint32_t)col;
+            m->values[begin + k] = 1.0 / (double)(k + 1);
+        }
+        qsort(m->col_idx + begin, len, sizeof(uint32_t), compare_uint32);
+    }
+    return 1;
+}
+
+// y = A * x for rows [row_begin, row_end)
+void spmv_csr_rows(const csr_matrix_t* m, const double* x, double* y, size_t row_begin, size_t row_end) {
+    for (size_t r = row_begin; r < row_end; r++) {
+        double sum = 0.0;
+        for (size_t k = m->row_ptr[r]; k < m->row_ptr[r + 1]; k++) {
+            sum += m->values[k] * x[m->col_idx[k]];
+        }
+        y[r] = sum;
+    }
+}
+
+// First row whose non-zeros start at or after `target`, for nnz-balanced partitions
+size_t csr_row_for_nnz(const csr_matrix_t* m, size_t target) {
+    size_t lo = 0, hi = m->rows;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (m->row_ptr[mid] < target) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+typedef struct {
+    const csr_matrix_t* matrix;
+    const double* x;
+    double* y;
+    int iterations;
+} spmv_args_t;
+
+void spmv_worker(thread_ctx_t* ctx) {
+    spmv_args_t* args = (spmv_args_t*)ctx->shared;
+    const csr_matrix_t* m = args->matrix;
+    size_t row_begin = csr_row_for_nnz(m, m->nnz * ctx->thread_id / ctx->num_threads);
+    size_t row_end = csr_row_for_nnz(m, m->nnz * (ctx->thread_id + 1) / ctx->num_threads);
+    if (ctx->thread_id == ctx->num_threads - 1) row_end = m->rows;
+    
+    thread_trace_mark(ctx, "warmup");
+    spmv_csr_rows(m, args->x, args->y, row_begin, row_end);  // Warmup
+    
+    thread_timed_begin(ctx);
+    for (int iter = 0; iter < args->iterations; iter++) {
+        spmv_csr_rows(m, args->x, args->y, row_begin, row_end);
+    }
+    thread_timed_end(ctx);
+}
+
+// Compulsory bytes per pass: matrix arrays once, x read once, y written once
+size_t spmv_bytes_per_pass(const csr_matrix_t* m) {
+    return m->nnz * (sizeof(double) + sizeof(uint32_t)) +
+           (m->rows + 1) * sizeof(size_t) + m->cols * sizeof(double) + m->rows * sizeof(double);
+}
+
+void display_spmv(const char* test_name, double time_taken, const csr_matrix_t* m,
+                  int iterations, double seq_read_gbps) {
+    double total_data_gb = (double)spmv_bytes_per_pass(m) * iterations / (1024.0 * 1024.0 * 1024.0);
+    double bandwidth_gbps = total_data_gb / time_taken;
+    double gflops = 2.0 * m->nnz * iterations / time_taken / 1e9;
+    record_bandwidth(test_name, bandwidth_gbps);
+    
+    printf("%-20s: %8.3f GB/s (%5.1f%% of seq read) - %6.3f GFLOP/s - Time: %.3f seconds\n",
+           test_name, bandwidth_gbps, 100.0 * bandwidth_gbps / seq_read_gbps, gflops, time_taken);
+}
+
+// Run SpMV for each matrix kind with a footprint of about `footprint` bytes
+void run_spmv_tests(size_t footprint, int num_threads) {
+    size_t bytes_per_row = SPMV_NNZ_PER_ROW * (sizeof(double) + sizeof(uint32_t)) + 3 * sizeof(double);
+    size_t rows = footprint / bytes_per_row;
+    if (rows > UINT32_MAX) rows = UINT32_MAX;
+    if (rows < 1024) rows = 1024;
+    
+    printf("\nRunning sparse matrix-vector (CSR) tests...\n");
+    printf("Matrix: %zu x %zu, ~%d non-zeros/row, ~%zu MB footprint\n",
+           rows, rows, SPMV_NNZ_PER_ROW, footprint / (1024 * 1024));
+    printf("%-20s  %-50s\n", "Test", "Effective Bandwidth");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    double* x = aligned_malloc(64, rows * sizeof(double));
+    double* y = aligned_malloc(64, rows * sizeof(double));
+    if (!x || !y) {
+        fprintf(stderr, "Failed to allocate SpMV vectors\n");
+        free(x);
+        free(y);
+        return;
+    }
+    for (size_t i = 0; i < rows; i++) {
+        x[i] = 1.0 + (double)(i & 7);
+        y[i] = 0.0;
+    }
+    
+    // Sequential read reference over a buffer with the same footprint
+    void* reference = aligned_malloc(64, footprint);
+    double seq_gbps[2] = {0.0, 0.0};
+    int thread_counts[2] = {1, num_threads};
+    int num_configs = num_threads > 1 ? 2 : 1;
+    if (!reference) {
+        fprintf(stderr, "Failed to allocate sequential read reference buffer\n");
+        free(x);
+        free(y);
+        return;
+    }
+    memset(reference, 0xAA, footprint);
+    for (int c = 0; c < num_configs; c++) {
+        char name[32];
+        double t = test_threaded_sequential_read(reference, footprint, SPMV_ITERATIONS, thread_counts[c]);
+        seq_gbps[c] = (double)footprint * SPMV_ITERATIONS / (1024.0 * 1024.0 * 1024.0) / t;
+        snprintf(name, sizeof(name), "Seq Read (%dT)", thread_counts[c]);
+        display_bandwidth(name, t, footprint, SPMV_ITERATIONS);
+    }
+    free(reference);
+    
+    matrix_kind_t kinds[] = {MATRIX_BANDED, MATRIX_POWER_LAW, MATRIX_UNIFORM};
+    for (int k = 0; k < 3; k++) {
+        csr_matrix_t m;
+        if (!generate_csr_matrix(&m, kinds[k], rows)) {
+            fprintf(stderr, "Failed to generate %s matrix\n", matrix_kind_name(kinds[k]));
+            continue;
+        }
+        for (int c = 0; c < num_configs; c++) {
+            char name[32];
+            spmv_args_t args = {&m, x, y, SPMV_ITERATIONS};
+            double t = run_threaded(thread_counts[c], spmv_worker, &args, NULL);
+            snprintf(name, sizeof(name), "SpMV %s (%dT)", matrix_kind_name(kinds[k]), thread_counts[c]);
+            if (t > 0) {
+                display_spmv(name, t, &m, SPMV_ITERATIONS, seq_gbps[c]);
+            }
+        }
+        free_csr_matrix(&m);
+    }
+    
+    free(x);
+    free(y);
+}
+
+// ---------------------------------------------------------------------------
+// Graph traversal (BFS and PageRank) on synthetic CSR graphs
+// ---------------------------------------------------------------------------
+
+#define GRAPH_NO_PARENT UINT32_MAX
+#define GRAPH_BATCH 256  // Frontier entries buffered per thread before publishing
+
+typedef enum { GRAPH_UNIFORM, GRAPH_RMAT } graph_kind_t;
+typedef enum { GRAPH_BFS_TOP_DOWN, GRAPH_BFS_BOTTOM_UP, GRAPH_PAGERANK } graph_algorithm_t;
+
+typedef struct {
+    uint32_t vertices;
+    size_t edges;          // Directed adjacency entries (2x undirected edges, self-loops dropped)
+    size_t* offsets;       // vertices + 1 entries
+    uint32_t* adjacency;   // edges entries
+} csr_graph_t;
+
+// Traversal state shared by the worker threads
+typedef struct {
+    const csr_graph_t* graph;
+    graph_algorithm_t algorithm;
+    uint32_t root;
+    uint32_t* parent;
+    uint32_t* frontier;          // Top-down: current frontier queue
+    uint32_t* next;              // Top-down: next frontier queue
+    size_t frontier_size;
+    size_t next_tail;
+    uint64_t* frontier_bits;     // Bottom-up: current frontier bitmap
+    uint64_t* next_bits;         // Bottom-up: next frontier bitmap
+    size_t added;
+    size_t last_added;
+    double* rank;                // PageRank
+    double* contrib;
+    size_t edges_examined;
+} graph_state_t;
+
+void free_csr_graph(csr_graph_t* g) {
+    free(g->offsets);
+    free(g->adjacency);
+    memset(g, 0, sizeof(*g));
+}
+
+// Pick one endpoint of an R-MAT edge: recursively choose a quadrant of the
+// adjacency matrix with probabilities a=0.57, b=0.19, c=0.19, d=0.05
+void rmat_edge(uint64_t* rng, int scale, uint32_t* u, uint32_t* v) {
+    uint32_t row = 0, col = 0;
+    for (int bit = 0; bit < scale; bit++) {
+        double r = xorshift64_unit(rng);
+        row <<= 1;
+        col <<= 1;
+        if (r < 0.57) {
+            // top-left quadrant
+        } else if (r < 0.76) {
+            col |= 1;
+        } else if (r < 0.95) {
+            row |= 1;
+        } else {
+            row |= 1;
+            col |= 1;
+        }
+    }
+    *u = row;
+    *v = col;
+}
+
+// Generate an undirected graph with 2^scale vertices and GRAPH_EDGE_FACTOR
+// edges per vertex, stored symmetrically in CSR form
+int generate_csr_graph(csr_graph_t* g, graph_kind_t kind, int scale) {
+    uint32_t n = 1u << scale;
+    size_t num_edges = (size_t)n * GRAPH_EDGE_FACTOR;
+    uint64_t rng = 0xD1B54A32D192ED03ULL + (uint64_t)scale * 2 + kind;
+    memset(g, 0, sizeof(*g));
+    
+    uint32_t* src = malloc(num_edges * sizeof(uint32_t));
+    uint32_t* dst = malloc(num_edges * sizeof(uint32_t));
+    uint32_t* relabel = malloc((size_t)n * sizeof(uint32_t));
+    g->offsets = calloc((size_t)n + 1, sizeof(size_t));
+    if (!src || !dst || !relabel || !g->offsets) {
+        free(src);
+        free(dst);
+        free(relabel);
+        free_csr_graph(g);
+        return 0;
+    }
+    
+    // Random relabeling so R-MAT hubs are not clustered at low vertex ids
+    for (uint32_t i = 0; i < n; i++) relabel[i] = i;
+    for (uint32_t i = n - 1; i > 0; i--) {
+        uint32_t j = (uint32_t)(xorshift64(&rng) % (i + 1));
+        uint32_t t = relabel[i];
+        relabel[i] = relabel[j];
+        relabel[j] = t;
+    }
+    
+    for (size_t e = 0; e < num_edges; e++) {
+        uint32_t u, v;
+        if (kind == GRAPH_RMAT) {
+            rmat_edge(&rng, scale, &u, &v);
+            u = relabel[u];
+            v = relabel[v];
+        } else {
+            u = (uint32_t)(xorshift64(&rng) % n);
+            v = (uint32_t)(xorshift64(&rng) % n);
+        }
+        src[e] = u;
+        dst[e] = v;
+        if (u != v) {
+            g->offsets[u + 1]++;
+            g->offsets[v + 1]++;
+        }
+    }
+    free(relabel);
+    
+    for (uint32_t i = 0; i < n; i++) {
+        g->offsets[i + 1] += g->offsets[i];
+    }
+    g->vertices = n;
+    g->edges = g->offsets[n];
+    g->adjacency = aligned_malloc(64, g->edges * sizeof(uint32_t));
+    size_t* fill = malloc((size_t)n * sizeof(size_t));
+    if (!g->adjacency || !fill) {
+        free(src);
+        free(dst);
+        free(fill);
+        free_csr_graph(g);
+        return 0;
+    }
+    memcpy(fill, g->offsets, (size_t)n * sizeof(size_t));
+    for (size_t e = 0; e < num_edges; e++) {
+        if (src[e] == dst[e]) continue;
+        g->adjacency[fill[src[e]]++] = dst[e];
+        g->adjacency[fill[dst[e]]++] = src[e];
+    }
+    
+    free(fill);
+    free(src);
+    free(dst);
+    return 1;
+}
+
+// Bytes of graph and per-vertex state the algorithm streams over
+size_t graph_footprint(const csr_graph_t* g, graph_algorithm_t algorithm) {
+    size_t structure = ((size_t)g->vertices + 1) * sizeof(size_t) + g->edges * sizeof(uint32_t);
+    switch (algorithm) {
+    case GRAPH_BFS_TOP_DOWN:
+        return structure + (size_t)g->vertices * 3 * sizeof(uint32_t);  // parent + two queues
+    case GRAPH_BFS_BOTTOM_UP:
+        return structure + (size_t)g->vertices * sizeof(uint32_t) + g->vertices / 4;  // parent + two bitmaps
+    case GRAPH_PAGERANK:
+        return structure + (size_t)g->vertices * 2 * sizeof(double);
+    }
+    return structure;
+}
+
+// Vertex range owned by a thread, aligned to 64 so bitmap words are never shared
+void graph_vertex_range(const thread_ctx_t* ctx, uint32_t n, uint32_t* begin, uint32_t* end) {
+    size_t words = ((size_t)n + 63) / 64;
+    size_t w0 = words * ctx->thread_id / ctx->num_threads;
+    size_t w1 = words * (ctx->thread_id + 1) / ctx->num_threads;
+    *begin = (uint32_t)(w0 * 64 < n ? w0 * 64 : n);
+    *end = (uint32_t)(w1 * 64 < n ? w1 * 64 : n);
+}
+
+void bfs_top_down_worker(thread_ctx_t* ctx, graph_state_t* st) {
+    const csr_graph_t* g = st->graph;
+    uint32_t batch[GRAPH_BATCH];
+    size_t edges = 0;
+    
+    for (;;) {
+        size_t fsize = st->frontier_size;
+        if (fsize == 0) break;
+        size_t begin = fsize * ctx->thread_id / ctx->num_threads;
+        size_t end = fsize * (ctx->thread_id + 1) / ctx->num_threads;
+        int batched = 0;
+        
+        for (size_t i = begin; i < end; i++) {
+            uint32_t u = st->frontier[i];
+            for (size_t k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+                uint32_t v = g->adjacency[k];
+                uint32_t expected = GRAPH_NO_PARENT;
+                edges++;
+                if (__atomic_load_n(&st->parent[v], __ATOMIC_RELAXED) != GRAPH_NO_PARENT) continue;
+                if (__atomic_compare_exchange_n(&st->parent[v], &expected, u, 0,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    batch[batched++] = v;
+                    if (batched == GRAPH_BATCH) {
+                        size_t at = __atomic_fetch_add(&st->next_tail, batched, __ATOMIC_RELAXED);
+                        memcpy(st->next + at, batch, batched * sizeof(uint32_t));
+                        batched = 0;
+                    }
+                }
+            }
+        }
+        if (batched) {
+            size_t at = __atomic_fetch_add(&st->next_tail, batched, __ATOMIC_RELAXED);
+            memcpy(st->next + at, batch, batched * sizeof(uint32_t));
+        }
+        
+        pthread_barrier_wait(ctx->barrier);
+        if (ctx->thread_id == 0) {
+            uint32_t* t = st->frontier;
+            st->frontier = st->next;
+            st->next = t;
+            st->frontier_size = st->next_tail;
+            st->next_tail = 0;
+        }
+        pthread_barrier_wait(ctx->barrier);
+    }
+    __atomic_fetch_add(&st->edges_examined, edges, __ATOMIC_RELAXED);
+}
+
+void bfs_bottom_up_worker(thread_ctx_t* ctx, graph_state_t* st) {
+    const csr_graph_t* g = st->graph;
+    uint32_t begin, end;
+    size_t edges = 0;
+    graph_vertex_range(ctx, g->vertices, &begin, &end);
+    
+    for (;;) {
+        size_t added = 0;
+        for (uint32_t v = begin; v < end; v++) {
+            if (st->parent[v] != GRAPH_NO_PARENT) continue;
+            for (size_t k = g->offsets[v]; k < g->offsets[v + 1]; k++) {
+                uint32_t u = g->adjacency[k];
+                edges++;
+                if (st->frontier_bits[u >> 6] & (1ULL << (u & 63))) {
+                    st->parent[v] = u;
+                    st->next_bits[v >> 6] |= 1ULL << (v & 63);
+                    added++;
+                    break;
+                }
+            }
+        }
+        __atomic_fetch_add(&st->added, added, __ATOMIC_RELAXED);
+        
+        pthread_barrier_wait(ctx->barrier);
+        if (ctx->thread_id == 0) {
+            uint64_t* t = st->frontier_bits;
+            st->frontier_bits = st->next_bits;
+            st->next_bits = t;
+            st->last_added = st->added;
+            st->added = 0;
+        }
+        pthread_barrier_wait(ctx->barrier);
+        
+        // Each thread clears the bitmap words it owns before they are reused
+        for (size_t w = begin / 64; w < ((size_t)end + 63) / 64; w++) {
+            st->next_bits[w] = 0;
+        }
+        if (st->last_added == 0) break;
+    }
+    __atomic_fetch_add(&st->edges_examined, edges, __ATOMIC_RELAXED);
+}
+
+void pagerank_worker(thread_ctx_t* ctx, graph_state_t* st) {
+    const csr_graph_t* g = st->graph;
+    const double damping = 0.85;
+    const double base = (1.0 - damping) / g->vertices;
+    uint32_t begin, end;
+    graph_vertex_range(ctx, g->vertices, &begin, &end);
+    
+    for (int iter = 0; iter < PAGERANK_ITERATIONS; iter++) {
+        for (uint32_t v = begin; v < end; v++) {
+            size_t degree = g->offsets[v + 1] - g->offsets[v];
+            st->contrib[v] = degree ? st->rank[v] / (double)degree : 0.0;
+        }
+        pthread_barrier_wait(ctx->barrier);
+        for (uint32_t v = begin; v < end; v++) {
+            double sum = 0.0;
+            for (size_t k = g->offsets[v]; k < g->offsets[v + 1]; k++) {
+                sum += st->contrib[g->adjacency[k]];
+            }
+            st->rank[v] = base + damping * sum;
+        }
+        pthread_barrier_wait(ctx->barrier);
+    }
+    if (ctx->thread_id == 0) {
+        __atomic_fetch_add(&st->edges_examined, g->edges * PAGERANK_ITERATIONS, __ATOMIC_RELAXED);
+    }
+}
+
+void graph_worker(thread_ctx_t* ctx) {
+    graph_state_t* st = (graph_state_t*)ctx->shared;
+    const csr_graph_t* g = st->graph;
+    uint32_t begin, end;
+    graph_vertex_range(ctx, g->vertices, &begin, &end);
+    
+    // Reset the state this thread owns; thread_timed_begin's barrier publishes it
+    if (st->algorithm == GRAPH_PAGERANK) {
+        for (uint32_t v = begin; v < end; v++) st->rank[v] = 1.0 / g->vertices;
+    } else {
+        for (uint32_t v = begin; v < end; v++) st->parent[v] = GRAPH_NO_PARENT;
+        if (st->algorithm == GRAPH_BFS_BOTTOM_UP) {
+            for (size_t w = begin / 64; w < ((size_t)end + 63) / 64; w++) {
+                st->frontier_bits[w] = 0;
+                st->next_bits[w] = 0;
+            }
+        }
+    }
+    pthread_barrier_wait(ctx->barrier);
+    if (ctx->thread_id == 0 && st->algorithm != GRAPH_PAGERANK) {
+        st->parent[st->root] = st->root;
+        st->frontier[0] = st->root;
+        st->frontier_size = 1;
+        st->next_tail = 0;
+        st->frontier_bits[st->root >> 6] |= 1ULL << (st->root & 63);
+        st->added = 0;
+    }
+    
+    thread_timed_begin(ctx);
+    switch (st->algorithm) {
+    case GRAPH_BFS_TOP_DOWN: bfs_top_down_worker(ctx, st); break;
+    case GRAPH_BFS_BOTTOM_UP: bfs_bottom_up_worker(ctx, st); break;
+    case GRAPH_PAGERANK: pagerank_worker(ctx, st); break;
+    }
+    thread_timed_end(ctx);
+}
+
+void display_graph(const char* test_name, double time_taken, size_t edges, size_t footprint) {
+    double mteps = (double)edges / time_taken / 1e6;
+    double bytes_per_edge = (double)footprint / (double)edges;
+    double bandwidth_gbps = (double)footprint / (1024.0 * 1024.0 * 1024.0) / time_taken;
+    record_bandwidth(test_name, bandwidth_gbps);
+    
+    printf("%-20s: %8.1f MTEPS - %6.2f bytes/edge - %7.3f GB/s - Time: %.3f seconds\n",
+           test_name, mteps, bytes_per_edge, bandwidth_gbps, time_taken);
+}
+
+// Run both BFS directions and PageRank on one graph
+void run_graph_case(graph_kind_t kind, int scale, const char* label, int num_threads) {
+    const char* kind_name = kind == GRAPH_RMAT ? "RMAT" : "Uniform";
+    csr_graph_t g;
+    if (!generate_csr_graph(&g, kind, scale)) {
+        fprintf(stderr, "Failed to generate %s graph (scale %d)\n", kind_name, scale);
+        return;
+    }
+    
+    graph_state_t st;
+    memset(&st, 0, sizeof(st));
+    st.graph = &g;
+    size_t bitmap_words = ((size_t)g.vertices + 63) / 64;
+    st.parent = aligned_malloc(64, (size_t)g.vertices * sizeof(uint32_t));
+    st.frontier = aligned_malloc(64, (size_t)g.vertices * sizeof(uint32_t));
+    st.next = aligned_malloc(64, (size_t)g.vertices * sizeof(uint32_t));
+    st.frontier_bits = aligned_malloc(64, bitmap_words * sizeof(uint64_t));
+    st.next_bits = aligned_malloc(64, bitmap_words * sizeof(uint64_t));
+    st.rank = aligned_malloc(64, (size_t)g.vertices * sizeof(double));
+    st.contrib = aligned_malloc(64, (size_t)g.vertices * sizeof(double));
+    
+    if (st.parent && st.frontier && st.next && st.frontier_bits && st.next_bits && st.rank && st.contrib) {
+        printf("[%s scale %d: %u vertices, %zu edges, %.1f MB CSR, sized for %s]\n",
+               kind_name, scale, g.vertices, g.edges,
+               (double)graph_footprint(&g, GRAPH_PAGERANK) / (1024.0 * 1024.0), label);
+        snprintf(record_case, sizeof(record_case), "%s scale %d", kind_name, scale);
+        
+        // Roots are spread over the vertex ids and skip isolated vertices
+        uint32_t roots[GRAPH_BFS_ROOTS];
+        uint64_t rng = 0x2545F4914F6CDD1DULL ^ (uint64_t)scale;
+        for (int r = 0; r < GRAPH_BFS_ROOTS; r++) {
+            uint32_t v = (uint32_t)(xorshift64(&rng) % g.vertices);
+            while (g.offsets[v + 1] == g.offsets[v]) v = (v + 1) % g.vertices;
+            roots[r] = v;
+        }
+        
+        const graph_algorithm_t algorithms[] = {GRAPH_BFS_TOP_DOWN, GRAPH_BFS_BOTTOM_UP, GRAPH_PAGERANK};
+        const char* algorithm_names[] = {"BFS top-down", "BFS bottom-up", "PageRank"};
+        // Cache-resident graphs finish in microseconds, so repeat them to get measurable times
+        int repeat = g.edges < ((size_t)1 << 22) ? (int)(((size_t)1 << 22) / g.edges) : 1;
+        for (int a = 0; a < 3; a++) {
+            int runs = (algorithms[a] == GRAPH_PAGERANK ? 1 : GRAPH_BFS_ROOTS) * repeat;
+            double total_time = 0.0;
+            size_t total_edges = 0;
+            int ok = 1;
+            for (int r = 0; r < runs; r++) {
+                st.algorithm = algorithms[a];
+                st.root = roots[r % GRAPH_BFS_ROOTS];
+                st.edges_examined = 0;
+                double t = run_threaded(num_threads, graph_worker, &st, NULL);
+                if (t <= 0) {
+                    ok = 0;
+                    break;
+                }
+                total_time += t;
+                total_edges += st.edges_examined;
+            }
+            if (ok && total_edges > 0) {
+                char name[32];
+                snprintf(name, sizeof(name), "%s", algorithm_names[a]);
+                size_t passes = algorithms[a] == GRAPH_PAGERANK ? (size_t)PAGERANK_ITERATIONS * runs : (size_t)runs;
+                display_graph(name, total_time, total_edges, graph_footprint(&g, algorithms[a]) * passes);
+            }
+        }
+        record_case[0] = '\0';
+    } else {
+        fprintf(stderr, "Failed to allocate graph traversal state\n");
+    }
+    
+    free(st.parent);
+    free(st.frontier);
+    free(st.next);
+    free(st.frontier_bits);
+    free(st.next_bits);
+    free(st.rank);
+    free(st.contrib);
+    free_csr_graph(&g);
+}
+
+// Graph scale whose PageRank footprint is closest to, but not above, `bytes`
+int graph_scale_for_footprint(size_t bytes) {
+    size_t per_vertex = sizeof(size_t) + 2 * GRAPH_EDGE_FACTOR * sizeof(uint32_t) + 2 * sizeof(double);
+    int scale = 8;
+    while (scale < 30 && ((size_t)2 << scale) * per_vertex <= bytes) scale++;
+    return scale;
+}
+
+// Graph sizes follow the detected data caches (half of each level) plus one DRAM-sized graph
+void run_graph_tests(size_t dram_size, int num_threads) {
+    int scales[MAX_CACHE_LEVELS + 1];
+    char labels[MAX_CACHE_LEVELS + 1][32];
+    int num_scales = 0;
+    
+    for (int i = 0; i < num_cache_levels; i++) {
+        if (strcmp(cache_levels[i].type, "Instruction") == 0) continue;
+        int scale = graph_scale_for_footprint(cache_levels[i].size_kb * 1024 / 2);
+        int duplicate = 0;
+        for (int j = 0; j < num_scales; j++) duplicate |= scales[j] == scale;
+        if (duplicate) continue;
+        scales[num_scales] = scale;
+        snprintf(labels[num_scales], sizeof(labels[0]), "L%d (%zu KB)", cache_levels[i].level, cache_levels[i].size_kb);
+        num_scales++;
+    }
+    if (num_scales == 0) {
+        scales[num_scales] = graph_scale_for_footprint(MB_TO_BYTES(1));
+        snprintf(labels[num_scales++], sizeof(labels[0]), "1 MB (no cache info)");
+    }
+    // The DRAM graph must be well past the last-level cache to be served from memory
+    size_t largest_cache = 0;
+    for (int i = 0; i < num_cache_levels; i++) {
+        if (cache_levels[i].size_kb * 1024 > largest_cache) largest_cache = cache_levels[i].size_kb * 1024;
+    }
+    if (dram_size < largest_cache * 2) dram_size = largest_cache * 2;
+    scales[num_scales] = graph_scale_for_footprint(dram_size);
+    snprintf(labels[num_scales++], sizeof(labels[0]), "DRAM (%zu MB)", dram_size / (1024 * 1024));
+    
+    printf("\nRunning graph traversal tests (%d thread%s)...\n", num_threads, num_threads == 1 ? "" : "s");
+    printf("%-20s  %-50s\n", "Test", "Traversal Rate");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < num_scales; i++) {
+        run_graph_case(GRAPH_UNIFORM, scales[i], labels[i], num_threads);
+        run_graph_case(GRAPH_RMAT, scales[i], labels[i], num_threads);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Matrix transpose: naive, cache-blocked, cache-oblivious and SIMD blocks
+// ---------------------------------------------------------------------------
+
+// All transposes read a rows x cols row-major matrix and write its cols x rows transpose
+
+void transpose_naive(const float* src, float* dst, size_t rows, size_t cols) {
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            dst[j * rows + i] = src[i * cols + j];
+        }
+    }
+}
+
+void transpose_blocked(const float* src, float* dst, size_t rows, size_t cols, size_t tile) {
+    for (size_t ii = 0; ii < rows; ii += tile) {
+        size_t i_end = ii + tile < rows ? ii + tile : rows;
+        for (size_t jj = 0; jj < cols; jj += tile) {
+            size_t j_end = jj + tile < cols ? jj + tile : cols;
+            for (size_t i = ii; i < i_end; i++) {
+                for (size_t j = jj; j < j_end; j++) {
+                    dst[j * rows + i] = src[i * cols + j];
+                }
+            }
+        }
+    }
+}
+
+// Split the longer side in half until the block is small, independent of cache sizes
+void transpose_recursive_block(const float* src, float* dst, size_t rows, size_t cols,
+                               size_t r0, size_t r1, size_t c0, size_t c1) {
+    size_t h = r1 - r0;
+    size_t w = c1 - c0;
+    if (h <= TRANSPOSE_RECURSION_BASE && w <= TRANSPOSE_RECURSION_BASE) {
+        for (size_t i = r0; i < r1; i++) {
+            for (size_t j = c0; j < c1; j++) {
+                dst[j * rows + i] = src[i * cols + j];
+            }
+        }
+    } else if (h >= w) {
+        size_t mid = r0 + h / 2;
+        transpose_recursive_block(src, dst, rows, cols, r0, mid, c0, c1);
+        transpose_recursive_block(src, dst, rows, cols, mid, r1, c0, c1);
+    } else {
+        size_t mid = c0 + w / 2;
+        transpose_recursive_block(src, dst, rows, cols, r0, r1, c0, mid);
+        transpose_recursive_block(src, dst, rows, cols, r0, r1, mid, c1);
+    }
+}
+
+void transpose_recursive(const float* src, float* dst, size_t rows, size_t cols) {
+    transpose_recursive_block(src, dst, rows, cols, 0, rows, 0, cols);
+}
+
+// Cache-blocked transpose whose inner kernel transposes 4x4 blocks in SSE registers
+void transpose_simd(const float* src, float* dst, size_t rows, size_t cols, size_t tile) {
+#ifdef HAVE_X86_INTRINSICS
+    size_t rows4 = rows & ~(size_t)3;
+    size_t cols4 = cols & ~(size_t)3;
+    for (size_t ii = 0; ii < rows4; ii += tile) {
+        size_t i_end = ii + tile < rows4 ? ii + tile : rows4;
+        for (size_t jj = 0; jj < cols4; jj += tile) {
+            size_t j_end = jj + tile < cols4 ? jj + tile : cols4;
+            for (size_t i = ii; i < i_end; i += 4) {
+                for (size_t j = jj; j < j_end; j += 4) {
+                    __m128 r0 = _mm_loadu_ps(src + (i + 0) * cols + j);
+                    __m128 r1 = _mm_loadu_ps(src + (i + 1) * cols + j);
+                    __m128 r2 = _mm_loadu_ps(src + (i + 2) * cols + j);
+                    __m128 r3 = _mm_loadu_ps(src + (i + 3) * cols + j);
+                    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                    _mm_storeu_ps(dst + (j + 0) * rows + i, r0);
+                    _mm_storeu_ps(dst + (j + 1) * rows + i, r1);
+                    _mm_storeu_ps(dst + (j + 2) * rows + i, r2);
+                    _mm_storeu_ps(dst + (j + 3) * rows + i, r3);
+                }
+            }
+        }
+    }
+    // Leftover rows and columns when a side is not a multiple of 4
+    for (size_t i = 0; i < rows; i++) {
+        size_t j_begin = i < rows4 ? cols4 : 0;
+        for (size_t j = j_begin; j < cols; j++) {
+            dst[j * rows + i] = src[i * cols + j];
+        }
+    }
+#else
+    transpose_blocked(src, dst, rows, cols, tile);
+#endif
+}
+
+typedef enum { TRANSPOSE_NAIVE, TRANSPOSE_BLOCKED, TRANSPOSE_RECURSIVE, TRANSPOSE_SIMD } transpose_kind_t;
+
+double test_transpose(transpose_kind_t kind, const float* src, float* dst,
+                      size_t rows, size_t cols, size_t tile, int iterations) {
+    double start_time = get_time();
+    for (int iter = 0; iter < iterations; iter++) {
+        switch (kind) {
+        case TRANSPOSE_NAIVE: transpose_naive(src, dst, rows, cols); break;
+        case TRANSPOSE_BLOCKED: transpose_blocked(src, dst, rows, cols, tile); break;
+        case TRANSPOSE_RECURSIVE: transpose_recursive(src, dst, rows, cols); break;
+        case TRANSPOSE_SIMD: transpose_simd(src, dst, rows, cols, tile); break;
+        }
+    }
+    return get_time() - start_time;
+}
+
+// Check every element once so a broken kernel cannot report a good number
+int verify_transpose(const float* src, const float* dst, size_t rows, size_t cols) {
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            if (dst[j * rows + i] != src[i * cols + j]) return 0;
+        }
+    }
+    return 1;
+}
+
+// Pick the fastest tile edge for the blocked kernel on this host
+size_t tune_transpose_tile(const float* src, float* dst, size_t rows, size_t cols) {
+    const size_t candidates[] = {8, 16, 32, 64, 128, 256};
+    size_t best_tile = 32;
+    double best_time = 0.0;
+    test_transpose(TRANSPOSE_BLOCKED, src, dst, rows, cols, best_tile, 1);  // Page in both matrices
+    for (int c = 0; c < 6; c++) {
+        double t = test_transpose(TRANSPOSE_BLOCKED, src, dst, rows, cols, candidates[c], ITERATIONS);
+        if (best_time == 0.0 || t < best_time) {
+            best_time = t;
+            best_tile = candidates[c];
+        }
+    }
+    return best_tile;
+}
+
+void run_transpose_tests(void) {
+    // Power-of-two shapes map columns of a tile onto few cache sets; the
+    // padded and odd shapes show the same work without the conflicts
+    const size_t shapes[][2] = {
+        {2048, 2048}, {2056, 2056}, {4096, 1024}, {1024, 4096}, {3000, 1500},
+    };
+    const int num_shapes = 5;
+    size_t max_elements = 0;
+    for (int s = 0; s < num_shapes; s++) {
+        if (shapes[s][0] * shapes[s][1] > max_elements) max_elements = shapes[s][0] * shapes[s][1];
+    }
+    
+    float* src = aligned_malloc(64, max_elements * sizeof(float));
+    float* dst = aligned_malloc(64, max_elements * sizeof(float));
+    if (!src || !dst) {
+        fprintf(stderr, "Failed to allocate transpose buffers\n");
+        free(src);
+        free(dst);
+        return;
+    }
+    for (size_t i = 0; i < max_elements; i++) {
+        src[i] = (float)i;
+    }
+    memset(dst, 0, max_elements * sizeof(float));
+    
+    size_t tile = tune_transpose_tile(src, dst, shapes[0][0], shapes[0][1]);
+    
+    printf("\nRunning matrix transpose tests (tuned tile: %zu x %zu)...\n", tile, tile);
+    printf("%-20s  %-50s\n", "Test", "Bandwidth (read + write)");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    const transpose_kind_t kinds[] = {TRANSPOSE_NAIVE, TRANSPOSE_BLOCKED, TRANSPOSE_RECURSIVE, TRANSPOSE_SIMD};
+    const char* kind_names[] = {"Naive", "Blocked", "Cache-oblivious", "SIMD 4x4 blocked"};
+    
+    for (int s = 0; s < num_shapes; s++) {
+        size_t rows = shapes[s][0];
+        size_t cols = shapes[s][1];
+        size_t bytes = rows * cols * sizeof(float);
+        int pow2 = (rows & (rows - 1)) == 0 && (cols & (cols - 1)) == 0;
+        
+        printf("[%zu x %zu%s, %.1f MB]\n", rows, cols, pow2 ? ", power of two" : "",
+               (double)bytes / (1024.0 * 1024.0));
+        snprintf(record_case, sizeof(record_case), "%zux%zu", rows, cols);
+        
+        double copy_time = test_memory_copy(src, dst, bytes, ITERATIONS);
+        display_bandwidth("Memory Copy", copy_time, bytes * 2, ITERATIONS);
+        
+        for (int k = 0; k < 4; k++) {
+            // Poison dst with NaNs so elements the kernel skips fail verification
+            memset(dst, 0xFF, bytes);
+            test_transpose(kinds[k], src, dst, rows, cols, tile, 1);  // Warmup and page-in
+            if (!verify_transpose(src, dst, rows, cols)) {
+                printf("%-20s: result mismatch, skipped\n", kind_names[k]);
+                continue;
+            }
+            double t = test_transpose(kinds[k], src, dst, rows, cols, tile, ITERATIONS);
+            display_bandwidth(kind_names[k], t, bytes * 2, ITERATIONS);
+        }
+    }
+    record_case[0] = '\0';
+    
+    free(src);
+    free(dst);
+}
+
+// ---------------------------------------------------------------------------
+// 2D 5-point and 3D 7-point Jacobi stencils with spatial and temporal tiling
+// ---------------------------------------------------------------------------
+
+typedef enum { STENCIL_NAIVE, STENCIL_SPATIAL, STENCIL_TEMPORAL } stencil_variant_t;
+
+typedef struct {
+    int dims;            // 2 or 3
+    size_t n;            // Points per side, boundary included
+    size_t tile;         // Spatial tile edge (innermost dimensions)
+    size_t time_tile;    // Temporal tile edge (outer dimensions, halo excluded)
+    double* scratch[2];  // Temporal tiling work buffers
+} stencil_grid_t;
+
+static inline double stencil5_point(const double* a, size_t row, size_t i, size_t j) {
+    return 0.2 * (a[i * row + j] + a[(i - 1) * row + j] + a[(i + 1) * row + j] +
+                  a[i * row + j - 1] + a[i * row + j + 1]);
+}
+
+static inline double stencil7_point(const double* a, size_t plane, size_t row,
+                                    size_t k, size_t i, size_t j) {
+    size_t c = k * plane + i * row + j;
+    return (1.0 / 7.0) * (a[c] + a[c - plane] + a[c + plane] + a[c - row] + a[c + row] +
+                          a[c - 1] + a[c + 1]);
+}
+
+// Range of rows a temporal tile may update at step t: shrinks by one per step
+// on cut sides, but stays fixed against the real domain boundary
+static inline void stencil_step_range(size_t lo, size_t hi, size_t n, int t, size_t* out_lo, size_t* out_hi) {
+    *out_lo = lo == 0 ? 1 : lo + t;
+    *out_hi = hi == n ? n - 1 : hi - t;
+}
+
+void stencil2d_sweep(const double* a, double* b, size_t n, size_t j_tile) {
+    for (size_t jj = 1; jj < n - 1; jj += j_tile) {
+        size_t j_end = jj + j_tile < n - 1 ? jj + j_tile : n - 1;
+        for (size_t i = 1; i < n - 1; i++) {
+            for (size_t j = jj; j < j_end; j++) {
+                b[i * n + j] = stencil5_point(a, n, i, j);
+            }
+        }
+    }
+}
+
+void stencil3d_sweep(const double* a, double* b, size_t n, size_t tile) {
+    size_t plane = n * n;
+    for (size_t ii = 1; ii < n - 1; ii += tile) {
+        size_t i_end = ii + tile < n - 1 ? ii + tile : n - 1;
+        for (size_t k = 1; k < n - 1; k++) {
+            for (size_t i = ii; i < i_end; i++) {
+                for (size_t j = 1; j < n - 1; j++) {
+                    b[k * plane + i * n + j] = stencil7_point(a, plane, n, k, i, j);
+                }
+            }
+        }
+    }
+}
+
+// Overlapped (ghost-zone) temporal blocking: copy a tile plus a halo of
+// STENCIL_TIME_BLOCK points into cache-sized scratch, advance it that many
+// sweeps there, and write back only the tile interior.
+void stencil2d_temporal(const double* a, double* b, stencil_grid_t* g) {
+    size_t n = g->n;
+    const size_t halo = STENCIL_TIME_BLOCK;
+    for (size_t r0 = 1; r0 < n - 1; r0 += g->time_tile) {
+        size_t r1 = r0 + g->time_tile < n - 1 ? r0 + g->time_tile : n - 1;
+        size_t lo_r = r0 > halo ? r0 - halo : 0;
+        size_t hi_r = r1 + halo < n ? r1 + halo : n;
+        for (size_t c0 = 1; c0 < n - 1; c0 += g->time_tile) {
+            size_t c1 = c0 + g->time_tile < n - 1 ? c0 + g->time_tile : n - 1;
+            size_t lo_c = c0 > halo ? c0 - halo : 0;
+            size_t hi_c = c1 + halo < n ? c1 + halo : n;
+            size_t w = hi_c - lo_c;
+            double* src = g->scratch[0];
+            double* dst = g->scratch[1];
+            
+            for (size_t i = lo_r; i < hi_r; i++) {
+                memcpy(src + (i - lo_r) * w, a + i * n + lo_c, w * sizeof(double));
+                memcpy(dst + (i - lo_r) * w, a + i * n + lo_c, w * sizeof(double));
+            }
+            for (int t = 1; t <= STENCIL_TIME_BLOCK; t++) {
+                size_t i0, i1, j0, j1;
+                stencil_step_range(lo_r, hi_r, n, t, &i0, &i1);
+                stencil_step_range(lo_c, hi_c, n, t, &j0, &j1);
+                for (size_t i = i0; i < i1; i++) {
+                    for (size_t j = j0; j < j1; j++) {
+                        dst[(i - lo_r) * w + (j - lo_c)] = stencil5_point(src, w, i - lo_r, j - lo_c);
+                    }
+                }
+                double* swap = src;
+                src = dst;
+                dst = swap;
+            }
+            for (size_t i = r0; i < r1; i++) {
+                memcpy(b + i * n + c0, src + (i - lo_r) * w + (c0 - lo_c), (c1 - c0) * sizeof(double));
+            }
+        }
+    }
+}
+
+// 3D version tiles the two outer dimensions and keeps full rows in x
+void stencil3d_temporal(const double* a, double* b, stencil_grid_t* g) {
+    size_t n = g->n;
+    size_t plane = n * n;
+    const size_t halo = STENCIL_TIME_BLOCK;
+    for (size_t k0 = 1; k0 < n - 1; k0 += g->time_tile) {
+        size_t k1 = k0 + g->time_tile < n - 1 ? k0 + g->time_tile : n - 1;
+        size_t lo_k = k0 > halo ? k0 - halo : 0;
+        size_t hi_k = k1 + halo < n ? k1 + halo : n;
+        for (size_t i0 = 1; i0 < n - 1; i0 += g->time_tile) {
+            size_t i1 = i0 + g->time_tile < n - 1 ? i0 + g->time_tile : n - 1;
+            size_t lo_i = i0 > halo ? i0 - halo : 0;
+            size_t hi_i = i1 + halo < n ? i1 + halo : n;
+            size_t h = hi_i - lo_i;
+            size_t local_plane = h * n;
+            double* src = g->scratch[0];
+            double* dst = g->scratch[1];
+            
+            for (size_t k = lo_k; k < hi_k; k++) {
+                memcpy(src + (k - lo_k) * local_plane, a + k * plane + lo_i * n, local_plane * sizeof(double));
+                memcpy(dst + (k - lo_k) * local_plane, a + k * plane + lo_i * n, local_plane * sizeof(double));
+            }
+            for (int t = 1; t <= STENCIL_TIME_BLOCK; t++) {
+                size_t ka, kb, ia, ib;
+                stencil_step_range(lo_k, hi_k, n, t, &ka, &kb);
+                stencil_step_range(lo_i, hi_i, n, t, &ia, &ib);
+                for (size_t k = ka; k < kb; k++) {
+                    for (size_t i = ia; i < ib; i++) {
+                        for (size_t j = 1; j < n - 1; j++) {
+                            dst[(k - lo_k) * local_plane + (i - lo_i) * n + j] =
+                                stencil7_point(src, local_plane, n, k - lo_k, i - lo_i, j);
+                        }
+                    }
+                }
+                double* swap = src;
+                src = dst;
+                dst = swap;
+            }
+            for (size_t k = k0; k < k1; k++) {
+                memcpy(b + k * plane + i0 * n, src + (k - lo_k) * local_plane + (i0 - lo_i) * n,
+                       (i1 - i0) * n * sizeof(double));
+            }
+        }
+    }
+}
+
+void stencil_init(double* a, double* b, size_t points) {
+    for (size_t p = 0; p < points; p++) {
+        a[p] = (double)(p % 97) * 0.01;
+        b[p] = a[p];  // Boundary values must match in both arrays
+    }
+}
+
+// Run STENCIL_STEPS sweeps; returns the array holding the final state
+double* stencil_run(stencil_grid_t* g, stencil_variant_t variant, double* a, double* b) {
+    int step_size = variant == STENCIL_TEMPORAL ? STENCIL_TIME_BLOCK : 1;
+    for (int step = 0; step < STENCIL_STEPS; step += step_size) {
+        switch (variant) {
+        case STENCIL_NAIVE:
+            if (g->dims == 2) stencil2d_sweep(a, b, g->n, g->n);
+            else stencil3d_sweep(a, b, g->n, g->n);
+            break;
+        case STENCIL_SPATIAL:
+            if (g->dims == 2) stencil2d_sweep(a, b, g->n, g->tile);
+            else stencil3d_sweep(a, b, g->n, g->tile);
+            break;
+        case STENCIL_TEMPORAL:
+            if (g->dims == 2) stencil2d_temporal(a, b, g);
+            else stencil3d_temporal(a, b, g);
+            break;
+        }
+        double* swap = a;
+        a = b;
+        b = swap;
+    }
+    return a;
+}
+
+// Operand bytes referenced per point update divided by modeled memory bytes.
+// Untiled sweeps move each point in and out once per step; temporal tiles move
+// the tile plus halo once per STENCIL_TIME_BLOCK steps.
+double stencil_reuse_factor(const stencil_grid_t* g, stencil_variant_t variant) {
+    double neighbors = g->dims == 2 ? 5.0 : 7.0;
+    double referenced = (neighbors + 1.0) * sizeof(double);  // loads + store per update
+    if (variant != STENCIL_TEMPORAL) {
+        return referenced / (2.0 * sizeof(double));
+    }
+    double tile = (double)g->time_tile;
+    double with_halo = tile + 2.0 * STENCIL_TIME_BLOCK;
+    double inner = (double)(g->n - 2);
+    // Points read (tile + halo) and written (tile) per tile, over the updates it retires
+    double read_ratio = g->dims == 2 ? (with_halo * with_halo) / (tile * tile)
+                                     : (with_halo * with_halo) / (tile * tile) * (double)g->n / inner;
+    double bytes_per_update = (read_ratio + 1.0) * sizeof(double) / STENCIL_TIME_BLOCK;
+    return referenced / bytes_per_update;
+}
+
+void run_stencil_case(int dims, size_t grid_bytes, const char* label) {
+    stencil_grid_t g;
+    memset(&g, 0, sizeof(g));
+    g.dims = dims;
+    
+    // Two grids share grid_bytes
+    size_t points_target = grid_bytes / (2 * sizeof(double));
+    size_t n = dims == 2 ? (size_t)sqrt((double)points_target) : (size_t)cbrt((double)points_target);
+    if (n < 2 * STENCIL_TIME_BLOCK + 4) n = 2 * STENCIL_TIME_BLOCK + 4;
+    g.n = n;
+    size_t points = dims == 2 ? n * n : n * n * n;
+    
+    size_t l1 = find_cache_size(1, KB_TO_BYTES(32));
+    size_t l2 = find_cache_size(2, KB_TO_BYTES(256));
+    if (dims == 2) {
+        // Spatial: 3 input rows and 1 output row of a column block fit in half of L1
+        g.tile = l1 / 2 / (4 * sizeof(double));
+        // Temporal: two (tile + halo)^2 scratch tiles fit in half of L2
+        g.time_tile = (size_t)sqrt((double)(l2 / 2 / (2 * sizeof(double))));
+    } else {
+        // Spatial: 3 input planes and 1 output plane of a y-block fit in half of L2
+        g.tile = l2 / 2 / (4 * sizeof(double) * n);
+        // Temporal: two (tile + halo)^2 x n scratch slabs fit in half of L2
+        g.time_tile = (size_t)sqrt((double)(l2 / 2 / (2 * sizeof(double) * n)));
+    }
+    if (g.tile < 4) g.tile = 4;
+    g.time_tile = g.time_tile > 3 * STENCIL_TIME_BLOCK ? g.time_tile - 2 * STENCIL_TIME_BLOCK : STENCIL_TIME_BLOCK;
+    
+    size_t with_halo = g.time_tile + 2 * STENCIL_TIME_BLOCK;
+    size_t scratch_points = dims == 2 ? with_halo * with_halo : with_halo * with_halo * n;
+    double* a = aligned_malloc(64, points * sizeof(double));
+    double* b = aligned_malloc(64, points * sizeof(double));
+    double* reference = aligned_malloc(64, points * sizeof(double));
+    g.scratch[0] = aligned_malloc(64, scratch_points * sizeof(double));
+    g.scratch[1] = aligned_malloc(64, scratch_points * sizeof(double));
+    
+    if (a && b && reference && g.scratch[0] && g.scratch[1]) {
+        printf("[%dD %s, %zu^%d grid, %.1f MB x 2, tile %zu, temporal tile %zu, %s]\n",
+               dims, dims == 2 ? "5-point" : "7-point", n, dims,
+               (double)points * sizeof(double) / (1024.0 * 1024.0), g.tile, g.time_tile, label);
+        
+        snprintf(record_case, sizeof(record_case), "%dD %s", dims, label);
+        
+        // Cache-resident grids finish quickly, so repeat them for at least 2^26 point updates
+        size_t min_updates = (size_t)1 << 26;
+        int reps = points * STENCIL_STEPS < min_updates ? (int)(min_updates / (points * STENCIL_STEPS)) : 1;
+        
+        const stencil_variant_t variants[] = {STENCIL_NAIVE, STENCIL_SPATIAL, STENCIL_TEMPORAL};
+        const char* names[] = {"Naive", "Spatial tiled", "Temporal blocked"};
+        for (int v = 0; v < 3; v++) {
+            stencil_init(a, b, points);
+            double start_time = get_time();
+            double* result = stencil_run(&g, variants[v], a, b);
+            double elapsed = get_time() - start_time;
+            
+            if (v == 0) {
+                memcpy(reference, result, points * sizeof(double));
+            } else {
+                double max_error = 0.0;
+                for (size_t p = 0; p < points; p++) {
+                    double e = fabs(result[p] - reference[p]);
+                    if (e > max_error) max_error = e;
+                }
+                if (max_error > 1e-9) {
+                    printf("%-20s: result mismatch (max error %g), skipped\n", names[v], max_error);
+                    continue;
+                }
+            }
+            
+            // Extra repetitions continue from the verified state
+            double* other = result == a ? b : a;
+            start_time = get_time();
+            for (int r = 1; r < reps; r++) {
+                result = stencil_run(&g, variants[v], result, other);
+                other = result == a ? b : a;
+            }
+            elapsed += get_time() - start_time;
+            
+            // Effective bandwidth: one read and one write of every point per sweep
+            double updates = (double)points * STENCIL_STEPS * reps;
+            double effective_gb = updates * 2.0 * sizeof(double) / (1024.0 * 1024.0 * 1024.0);
+            record_bandwidth(names[v], effective_gb / elapsed);
+            printf("%-20s: %8.3f GB/s effective - reuse %5.1fx - %8.1f MLUP/s - Time: %.3f seconds\n",
+                   names[v], effective_gb / elapsed, stencil_reuse_factor(&g, variants[v]),
+                   updates / elapsed / 1e6, elapsed);
+        }
+        record_case[0] = '\0';
+    } else {
+        fprintf(stderr, "Failed to allocate %dD stencil grids\n", dims);
+    }
+    
+    free(a);
+    free(b);
+    free(reference);
+    free(g.scratch[0]);
+    free(g.scratch[1]);
+}
+
+// Grid sizes: resident in L2, resident in L3, and past the last-level cache
+void run_stencil_tests(size_t dram_size) {
+    size_t l2 = find_cache_size(2, KB_TO_BYTES(256));
+    size_t l3 = find_cache_size(3, 0);
+    size_t llc = l3 ? l3 : l2;
+    size_t sizes[3];
+    const char* labels[3];
+    int num_sizes = 0;
+    
+    sizes[num_sizes] = l2 / 2;
+    labels[num_sizes++] = "fits L2";
+    if (l3) {
+        sizes[num_sizes] = l3 / 2;
+        labels[num_sizes++] = "fits L3";
+    }
+    sizes[num_sizes] = dram_size > llc * 2 ? dram_size : llc * 2;
+    labels[num_sizes++] = "exceeds LLC";
+    
+    printf("\nRunning stencil tests (%d sweeps, temporal block of %d)...\n", STENCIL_STEPS, STENCIL_TIME_BLOCK);
+    printf("%-20s  %-50s\n", "Test", "Effective Bandwidth");
+    printf("--------------------------------------------------------------------------------\n");
+    for (int dims = 2; dims <= 3; dims++) {
+        for (int i = 0; i < num_sizes; i++) {
+            run_stencil_case(dims, sizes[i], labels[i]);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Cache pollution: streaming aggressor versus a cache-resident victim
+// ---------------------------------------------------------------------------
+
+typedef enum {
+    AGGRESSOR_NONE,
+    AGGRESSOR_LOADS,
+    AGGRESSOR_NTA_LOADS,
+    AGGRESSOR_STORES,
+    AGGRESSOR_NT_STORES,
+} aggressor_mode_t;
+
+typedef struct {
+    void* victim_buffer;       // Pointer chain built by build_pointer_chain
+    void* aggressor_buffer;
+    size_t aggressor_size;
+    aggressor_mode_t mode;
+    int victim_cpu;
+    int aggressor_cpu;
+    volatile int stop;
+    double victim_time;
+    size_t aggressor_bytes;
+    double aggressor_time;
+} pollution_args_t;
+
+const char* aggressor_mode_name(aggressor_mode_t mode) {
+    switch (mode) {
+    case AGGRESSOR_NONE: return "none";
+    case AGGRESSOR_LOADS: return "loads";
+    case AGGRESSOR_NTA_LOADS: return "prefetchnta loads";
+    case AGGRESSOR_STORES: return "stores";
+    case AGGRESSOR_NT_STORES: return "NT stores";
+    }
+    return "unknown";
+}
+
+int aggressor_mode_available(aggressor_mode_t mode) {
+#ifdef HAVE_X86_INTRINSICS
+    (void)mode;
+    return 1;
+#else
+    return mode != AGGRESSOR_NTA_LOADS && mode != AGGRESSOR_NT_STORES;
+#endif
+}
+
+// One pass of the aggressor over its buffer, touching every cache line
+uint64_t aggressor_pass(aggressor_mode_t mode, void* buffer, size_t size) {
+    uint64_t* data = (uint64_t*)buffer;
+    size_t lines = size / 64;
+    uint64_t sum = 0;
+    
+    switch (mode) {
+    case AGGRESSOR_NONE:
+        break;
+    case AGGRESSOR_LOADS:
+        for (size_t i = 0; i < lines; i++) {
+            sum += data[i * 8];
+        }
+        break;
+    case AGGRESSOR_NTA_LOADS:
+#ifdef HAVE_X86_INTRINSICS
+        for (size_t i = 0; i < lines; i++) {
+            _mm_prefetch((const char*)(data + (i + 8) * 8), _MM_HINT_NTA);
+            sum += data[i * 8];
+        }
+#endif
+        break;
+    case AGGRESSOR_STORES:
+        for (size_t i = 0; i < lines; i++) {
+            for (int w = 0; w < 8; w++) data[i * 8 + w] = i;
+        }
+        break;
+    case AGGRESSOR_NT_STORES:
+#ifdef HAVE_X86_INTRINSICS
+        for (size_t i = 0; i < lines; i++) {
+            __m128i v = _mm_set1_epi64x((long long)i);
+            __m128i* line = (__m128i*)(data + i * 8);
+            _mm_stream_si128(line + 0, v);
+            _mm_stream_si128(line + 1, v);
+            _mm_stream_si128(line + 2, v);
+            _mm_stream_si128(line + 3, v);
+        }
+        _mm_sfence();
+#endif
+        break;
+    }
+    return sum;
+}
+
+// Thread 0 is the victim chasing its chain, thread 1 the streaming aggressor
+void pollution_worker(thread_ctx_t* ctx) {
+    pollution_args_t* args = (pollution_args_t*)ctx->shared;
+    
+    if (ctx->thread_id == 0) {
+        pin_thread_to_cpu(args->victim_cpu);
+        thread_trace_mark(ctx, "warmup");
+        chase_pointer_chain(args->victim_buffer, LATENCY_ACCESSES / 10);  // Re-warm on this CPU
+        thread_timed_begin(ctx);
+        double ramp_end = get_time() + POLLUTION_RAMP_SECONDS;
+        while (args->mode != AGGRESSOR_NONE && get_time() < ramp_end) {
+            // Let the aggressor reach steady state first
+        }
+        args->victim_time = chase_pointer_chain(args->victim_buffer, LATENCY_ACCESSES);
+        args->stop = 1;
+        thread_timed_end(ctx);
+    } else {
+        pin_thread_to_cpu(args->aggressor_cpu);
+        uint64_t sum = 0;
+        size_t bytes = 0;
+        thread_timed_begin(ctx);
+        double start_time = get_time();
+        while (!args->stop && args->mode != AGGRESSOR_NONE) {
+            sum += aggressor_pass(args->mode, args->aggressor_buffer, args->aggressor_size);
+            bytes += args->aggressor_size;
+        }
+        args->aggressor_time = get_time() - start_time;
+        args->aggressor_bytes = bytes;
+        thread_timed_end(ctx);
+        ctx->sink = sum;
+    }
+}
+
+void run_pollution_tests(size_t aggressor_size) {
+    size_t l2 = find_cache_size(2, KB_TO_BYTES(256));
+    size_t l3 = find_cache_size(3, 0);
+    size_t llc = l3 ? l3 : l2;
+    if (aggressor_size < llc * 4) aggressor_size = llc * 4;
+    
+    int victim_cpu = sched_getcpu();
+    if (victim_cpu < 0) victim_cpu = 0;
+    int aggressor_cpu = find_llc_neighbor_cpu(victim_cpu);
+    
+    printf("\nRunning cache pollution tests (victim on CPU %d, aggressor on CPU %d, %zu MB aggressor buffer)...\n",
+           victim_cpu, aggressor_cpu, aggressor_size / (1024 * 1024));
+    if (aggressor_cpu == victim_cpu) {
+        printf("Warning: only one CPU available; the aggressor time-shares with the victim\n");
+    }
+    printf("%-12s %-18s %-22s %-12s %-14s\n", "Victim WS", "Aggressor", "Victim Latency", "Inflation", "Aggressor BW");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    void* aggressor_buffer = aligned_malloc(64, aggressor_size);
+    if (!aggressor_buffer) {
+        fprintf(stderr, "Failed to allocate aggressor buffer\n");
+        return;
+    }
+    memset(aggressor_buffer, 0x5A, aggressor_size);
+    
+    // The victim runs on thread 0, which is this thread; undo its pin afterwards
+    cpu_set_t saved_affinity;
+    pthread_getaffinity_np(pthread_self(), sizeof(saved_affinity), &saved_affinity);
+    
+    // Victim working sets: three quarters of L2, and half of L3
+    size_t victim_sizes[2] = {l2 * 3 / 4, l3 / 2};
+    const char* victim_levels[2] = {"L2", "L3"};
+    int num_victims = l3 ? 2 : 1;
+    const aggressor_mode_t modes[] = {
+        AGGRESSOR_NONE, AGGRESSOR_LOADS, AGGRESSOR_NTA_LOADS, AGGRESSOR_STORES, AGGRESSOR_NT_STORES
+    };
+    
+    for (int v = 0; v < num_victims; v++) {
+        void* victim_buffer = aligned_malloc(64, victim_sizes[v]);
+        if (!victim_buffer || !build_pointer_chain(victim_buffer, victim_sizes[v])) {
+            fprintf(stderr, "Failed to set up %s victim working set\n", victim_levels[v]);
+            free(victim_buffer);
+            continue;
+        }
+        char ws_name[32];
+        if (victim_sizes[v] >= MB_TO_BYTES(1)) {
+            snprintf(ws_name, sizeof(ws_name), "%zuMB(%s)", victim_sizes[v] / (1024 * 1024), victim_levels[v]);
+        } else {
+            snprintf(ws_name, sizeof(ws_name), "%zuKB(%s)", victim_sizes[v] / 1024, victim_levels[v]);
+        }
+        
+        double baseline_ns = 0.0;
+        for (int m = 0; m < 5; m++) {
+            if (!aggressor_mode_available(modes[m])) {
+                printf("%-12s %-18s %s\n", ws_name, aggressor_mode_name(modes[m]), "n/a on this architecture");
+                continue;
+            }
+            pollution_args_t args;
+            memset(&args, 0, sizeof(args));
+            args.victim_buffer = victim_buffer;
+            args.aggressor_buffer = aggressor_buffer;
+            args.aggressor_size = aggressor_size;
+            args.mode = modes[m];
+            args.victim_cpu = victim_cpu;
+            args.aggressor_cpu = aggressor_cpu;
+            
+            if (run_threaded(2, pollution_worker, &args, NULL) < 0) continue;
+            double latency_ns = args.victim_time * 1e9 / LATENCY_ACCESSES;
+            char victim_label[48];
+            snprintf(victim_label, sizeof(victim_label), "Victim, %s aggressor", aggressor_mode_name(modes[m]));
+            snprintf(record_case, sizeof(record_case), "%s", ws_name);
+            record_latency(victim_label, victim_sizes[v], latency_ns);
+            if (modes[m] == AGGRESSOR_NONE) {
+                baseline_ns = latency_ns;
+                printf("%-12s %-18s %8.1f ns/access       %-12s %-14s\n",
+                       ws_name, aggressor_mode_name(modes[m]), latency_ns, "baseline", "-");
+            } else {
+                double gbps = args.aggressor_time > 0
+                    ? (double)args.aggressor_bytes / (1024.0 * 1024.0 * 1024.0) / args.aggressor_time : 0.0;
+                printf("%-12s %-18s %8.1f ns/access     %+8.1f%%    %8.3f GB/s\n",
+                       ws_name, aggressor_mode_name(modes[m]), latency_ns,
+                       100.0 * (latency_ns - baseline_ns) / baseline_ns, gbps);
+            }
+        }
+        free(victim_buffer);
+    }
+    record_case[0] = '\0';
+    
+    pthread_setaffinity_np(pthread_self(), sizeof(saved_affinity), &saved_affinity);
+    free(aggressor_buffer);
+}
+
+// ---------------------------------------------------------------------------
+// Software prefetch hints and resulting cache residency
+// ---------------------------------------------------------------------------
+
+typedef enum {
+    PREFETCH_NONE,
+    PREFETCH_T0,
+    PREFETCH_T1,
+    PREFETCH_T2,
+    PREFETCH_NTA,
+    PREFETCH_W,
+} prefetch_hint_t;
+
+const char* prefetch_hint_name(prefetch_hint_t hint) {
+    switch (hint) {
+    case PREFETCH_NONE: return "none";
+    case PREFETCH_T0: return "T0";
+    case PREFETCH_T1: return "T1";
+    case PREFETCH_T2: return "T2";
+    case PREFETCH_NTA: return "NTA";
+    case PREFETCH_W: return "W";
+    }
+    return "?";
+}
+
+#ifdef HAVE_X86_INTRINSICS
+__attribute__((target("prfchw")))
+static inline void prefetch_for_write(const void* p) {
+    _m_prefetchw((void*)p);
+}
+#endif
+
+// Whether the CPU implements PREFETCHW (CPUID 0x80000001 ECX bit 8)
+int cpu_has_prefetchw(void) {
+#ifdef HAVE_X86_INTRINSICS
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx)) {
+        return (ecx >> 8) & 1;
+    }
+#endif
+    return 0;
+}
+
+static inline void issue_prefetch(const void* p, prefetch_hint_t hint) {
+#ifdef HAVE_X86_INTRINSICS
+    switch (hint) {
+    case PREFETCH_NONE: break;
+    case PREFETCH_T0: _mm_prefetch((const char*)p, _MM_HINT_T0); break;
+    case PREFETCH_T1: _mm_prefetch((const char*)p, _MM_HINT_T1); break;
+    case PREFETCH_T2: _mm_prefetch((const char*)p, _MM_HINT_T2); break;
+    case PREFETCH_NTA: _mm_prefetch((const char*)p, _MM_HINT_NTA); break;
+    case PREFETCH_W: prefetch_for_write(p); break;
+    }
+#else
+    if (hint != PREFETCH_NONE) __builtin_prefetch(p, hint == PREFETCH_W, 3);
+#endif
+}
+
+// Evict a buffer from every cache level so each pass starts from DRAM
+void flush_buffer(const void* buffer, size_t size) {
+#ifdef HAVE_X86_INTRINSICS
+    const char* p = (const char*)buffer;
+    for (size_t off = 0; off < size; off += 64) {
+        _mm_clflush(p + off);
+    }
+    _mm_mfence();
+#else
+    (void)buffer;
+    (void)size;
+#endif
+}
+
+// One pass over every line of the buffer, in `order` (line indices) or
+// sequentially when order is NULL, prefetching PREFETCH_DISTANCE_LINES ahead
+uint64_t prefetch_kernel_pass(uint64_t* data, size_t lines, const uint32_t* order,
+                              int write, prefetch_hint_t hint) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < lines; i++) {
+        size_t line = order ? order[i] : i;
+        size_t ahead = i + PREFETCH_DISTANCE_LINES;
+        if (ahead < lines) {
+            issue_prefetch(data + (order ? order[ahead] : ahead) * 8, hint);
+        }
+        uint64_t* p = data + line * 8;
+        if (write) {
+            for (int w = 0; w < 8; w++) p[w] = line + w;
+        } else {
+            for (int w = 0; w < 8; w++) sum += p[w];
+        }
+    }
+    return sum;
+}
+
+// Average latency of dependent loads to a random sample of the buffer's lines,
+// without warming them first, so it shows where the last pass left the data
+double residency_probe(const uint64_t* data, const uint32_t* sample, size_t count) {
+    static volatile uint64_t zero = 0;
+    uint64_t mask = zero;  // Always 0, but the compiler cannot prove it
+    uint64_t v = 0;
+    double start_time = get_time();
+    for (size_t i = 0; i < count; i++) {
+        v = data[(size_t)sample[i] * 8 + (v & mask)];
+    }
+    double elapsed = get_time() - start_time;
+    if (v == 0x123456789ULL) printf("Unexpected probe value\n");
+    return elapsed * 1e9 / count;
+}
+
+typedef struct {
+    const char* name;
+    double latency_ns;
+} residency_reference_t;
+
+// Label a probe latency with the level whose chase latency is closest (log scale)
+const char* classify_residency(double latency_ns, const residency_reference_t* refs, int num_refs) {
+    const char* best = "unknown";
+    double best_distance = 0.0;
+    for (int i = 0; i < num_refs; i++) {
+        if (refs[i].latency_ns <= 0) continue;
+        double distance = fabs(log(latency_ns / refs[i].latency_ns));
+        if (best_distance == 0.0 || distance < best_distance) {
+            best_distance = distance;
+            best = refs[i].name;
+        }
+    }
+    return best;
+}
+
+// Chase latency of a buffer of the given size, in ns/access
+double measure_chase_ns(size_t size) {
+    void* buffer = aligned_malloc(64, size);
+    if (!buffer) return -1.0;
+    double t = test_memory_latency(buffer, size, LATENCY_ACCESSES / 4);
+    free(buffer);
+    return t > 0 ? t * 1e9 / (LATENCY_ACCESSES / 4) : -1.0;
+}
+
+void run_prefetch_case(size_t size, const char* label, const residency_reference_t* refs, int num_refs) {
+    size_t lines = size / 64;
+    uint64_t* data = aligned_malloc(64, size);
+    uint32_t* order = malloc(lines * sizeof(uint32_t));
+    size_t probe_count = lines < RESIDENCY_PROBE_LINES ? lines : RESIDENCY_PROBE_LINES;
+    uint32_t* sample = malloc(probe_count * sizeof(uint32_t));
+    if (!data || !order || !sample) {
+        fprintf(stderr, "Failed to allocate prefetch test buffers\n");
+        free(data);
+        free(order);
+        free(sample);
+        return;
+    }
+    memset(data, 0x3C, size);
+    
+    // Random pattern: every line once per pass, in shuffled order
+    uint64_t rng = 0x853C49E6748FEA9BULL;
+    for (size_t i = 0; i < lines; i++) order[i] = (uint32_t)i;
+    for (size_t i = lines - 1; i > 0; i--) {
+        size_t j = xorshift64(&rng) % (i + 1);
+        uint32_t t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    for (size_t i = 0; i < probe_count; i++) {
+        sample[i] = (uint32_t)(xorshift64(&rng) % lines);
+    }
+    
+    printf("[%s, %zu KB buffer]\n", label, size / 1024);
+    snprintf(record_case, sizeof(record_case), "%s", label);
+    
+    const prefetch_hint_t read_hints[] = {PREFETCH_NONE, PREFETCH_T0, PREFETCH_T1, PREFETCH_T2, PREFETCH_NTA};
+    const prefetch_hint_t write_hints[] = {PREFETCH_NONE, PREFETCH_T0, PREFETCH_W};
+    int have_prefetchw = cpu_has_prefetchw();
+    uint64_t sink = 0;
+    
+    for (int write = 0; write <= 1; write++) {
+        for (int random = 0; random <= 1; random++) {
+            const prefetch_hint_t* hints = write ? write_hints : read_hints;
+            int num_hints = write ? 3 : 5;
+            for (int h = 0; h < num_hints; h++) {
+                char name[40];
+                snprintf(name, sizeof(name), "%s %s %s", random ? "Rand" : "Seq",
+                         write ? "write" : "read", prefetch_hint_name(hints[h]));
+                if (hints[h] == PREFETCH_W && !have_prefetchw) {
+                    printf("%-20s: n/a (no PREFETCHW)\n", name);
+                    continue;
+                }
+                double elapsed = 0.0;
+                for (int pass = 0; pass < PREFETCH_PASSES; pass++) {
+                    flush_buffer(data, size);
+                    double start_time = get_time();
+                    sink += prefetch_kernel_pass(data, lines, random ? order : NULL, write, hints[h]);
+                    elapsed += get_time() - start_time;
+                }
+                double probe_ns = residency_probe(data, sample, probe_count);
+                double gbps = (double)size * PREFETCH_PASSES / (1024.0 * 1024.0 * 1024.0) / elapsed;
+                record_bandwidth(name, gbps);
+                printf("%-20s: %8.3f GB/s - probe %7.1f ns - residency: %s\n",
+                       name, gbps, probe_ns, classify_residency(probe_ns, refs, num_refs));
+            }
+        }
+    }
+    if (sink == 1) printf("Unexpected prefetch sink\n");
+    record_case[0] = '\0';
+    
+    free(data);
+    free(order);
+    free(sample);
+}
+
+void run_prefetch_tests(size_t dram_size) {
+    size_t l1 = find_cache_size(1, KB_TO_BYTES(32));
+    size_t l2 = find_cache_size(2, KB_TO_BYTES(256));
+    size_t l3 = find_cache_size(3, 0);
+    size_t llc = l3 ? l3 : l2;
+    if (dram_size < llc * 2) dram_size = llc * 2;
+    
+    printf("\nRunning prefetch hint tests (distance %d lines, caches flushed before each pass)...\n",
+           PREFETCH_DISTANCE_LINES);
+    
+    // Reference chase latencies for labeling probe results
+    residency_reference_t refs[4];
+    int num_refs = 0;
+    refs[num_refs++] = (residency_reference_t){"L1", measure_chase_ns(l1 / 2)};
+    refs[num_refs++] = (residency_reference_t){"L2", measure_chase_ns(l2 / 2)};
+    if (l3) refs[num_refs++] = (residency_reference_t){"L3", measure_chase_ns(l3 / 2)};
+    refs[num_refs++] = (residency_reference_t){"DRAM", measure_chase_ns(dram_size)};
+    printf("Reference latencies:");
+    for (int i = 0; i < num_refs; i++) {
+        printf(" %s %.1f ns%s", refs[i].name, refs[i].latency_ns, i + 1 < num_refs ? "," : "\n");
+    }
+    printf("%-20s  %-50s\n", "Test", "Bandwidth / Residency Probe");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    run_prefetch_case(l2 / 2, "fits L2", refs, num_refs);
+    if (l3) run_prefetch_case(l3 / 2, "fits L3", refs, num_refs);
+}
+
+// ---------------------------------------------------------------------------
+// Hardware prefetcher on/off comparison through MSRs
+// ---------------------------------------------------------------------------
+
+#define MSR_INTEL_MISC_FEATURE_CONTROL 0x1A4   // Bits 0-3: L2 streamer, L2 adjacent line, DCU streamer, DCU IP
+#define MSR_INTEL_PREFETCH_DISABLE_BITS 0xFULL
+#define MSR_AMD_PREFETCH_CONTROL 0xC0000108     // Zen 3+: bits 0-3 L1 stream/stride/region, L2 stream; bit 5 up/down
+#define MSR_AMD_PREFETCH_DISABLE_BITS 0x2FULL
+
+typedef struct {
+    uint32_t msr;
+    uint64_t disable_bits;
+    const char* vendor;
+    int num_cpus;
+    int cpus[MAX_CPUS];
+    int fds[MAX_CPUS];
+    uint64_t saved[MAX_CPUS];
+    int modified;
+} msr_prefetch_state_t;
+
+static msr_prefetch_state_t msr_state;
+
+// Put every CPU's prefetcher MSR back to the value read at startup
+void msr_prefetch_restore(void) {
+    if (!msr_state.modified) return;
+    for (int i = 0; i < msr_state.num_cpus; i++) {
+        if (pwrite(msr_state.fds[i], &msr_state.saved[i], sizeof(uint64_t), msr_state.msr) != sizeof(uint64_t)) {
+            fprintf(stderr, "Failed to restore MSR 0x%X on CPU %d\n", msr_state.msr, msr_state.cpus[i]);
+        }
+    }
+    msr_state.modified = 0;
+}
+
+// Restore prefetchers if interrupted mid-run; pwrite is async-signal-safe
+void msr_prefetch_signal_handler(int sig) {
+    for (int i = 0; msr_state.modified && i < msr_state.num_cpus; i++) {
+        if (pwrite(msr_state.fds[i], &msr_state.saved[i], sizeof(uint64_t), msr_state.msr) < 0) {
+            // Nothing more can be done from a signal handler
+        }
+    }
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+void msr_prefetch_close(void) {
+    for (int i = 0; i < msr_state.num_cpus; i++) {
+        close(msr_state.fds[i]);
+    }
+    msr_state.num_cpus = 0;
+}
+
+// Select the documented prefetcher MSR for this CPU and open it on every
+// online CPU. Returns a reason string on failure, NULL on success.
+const char* msr_prefetch_open(void) {
+    memset(&msr_state, 0, sizeof(msr_state));
+#ifdef HAVE_X86_INTRINSICS
+    unsigned int eax, ebx, ecx, edx;
+    char vendor[13] = {0};
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return "CPUID unavailable";
+    memcpy(vendor + 0, &ebx, 4);
+    memcpy(vendor + 4, &edx, 4);
+    memcpy(vendor + 8, &ecx, 4);
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    unsigned int family = (eax >> 8) & 0xF;
+    if (family == 0xF) family += (eax >> 20) & 0xFF;
+    
+    if (strcmp(vendor, "GenuineIntel") == 0) {
+        msr_state.msr = MSR_INTEL_MISC_FEATURE_CONTROL;
+        msr_state.disable_bits = MSR_INTEL_PREFETCH_DISABLE_BITS;
+        msr_state.vendor = "Intel";
+    } else if (strcmp(vendor, "AuthenticAMD") == 0 && family >= 0x19) {
+        msr_state.msr = MSR_AMD_PREFETCH_CONTROL;
+        msr_state.disable_bits = MSR_AMD_PREFETCH_DISABLE_BITS;
+        msr_state.vendor = "AMD";
+    } else {
+        return "no documented prefetcher control MSR for this CPU";
+    }
+#else
+    return "MSR prefetcher control is only implemented for x86";
+#endif
+    
+    int online[MAX_CPUS];
+    int num_online = read_cpu_list_file("/sys/devices/system/cpu/online", online, MAX_CPUS);
+    if (num_online == 0) return "cannot read /sys/devices/system/cpu/online";
+    
+    for (int i = 0; i < num_online; i++) {
+        char path[64];
+        snprintf(path, sizeof(path), "/dev/cpu/%d/msr", online[i]);
+        int fd = open(path, O_RDWR);
+        if (fd < 0) {
+            msr_prefetch_close();
+            return access("/dev/cpu/0/msr", F_OK) == 0
+                ? "/dev/cpu/*/msr is not writable (requires root)"
+                : "/dev/cpu/*/msr not present (load the msr module)";
+        }
+        uint64_t value;
+        if (pread(fd, &value, sizeof(value), msr_state.msr) != sizeof(value)) {
+            close(fd);
+            msr_prefetch_close();
+            return "prefetcher MSR is not readable on this CPU";
+        }
+        msr_state.cpus[msr_state.num_cpus] = online[i];
+        msr_state.fds[msr_state.num_cpus] = fd;
+        msr_state.saved[msr_state.num_cpus] = value;
+        msr_state.num_cpus++;
+    }
+    return NULL;
+}
+
+// Set the disable bits on every CPU; returns 0 (after restoring) on failure
+int msr_prefetch_disable(void) {
+    msr_state.modified = 1;
+    for (int i = 0; i < msr_state.num_cpus; i++) {
+        uint64_t value = msr_state.saved[i] | msr_state.disable_bits;
+        if (pwrite(msr_state.fds[i], &value, sizeof(value), msr_state.msr) != sizeof(value)) {
+            msr_prefetch_restore();
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#define MSR_SUITE_TESTS 9
+
+// Sequential, strided and random suites; fills GB/s (or MIOPS for random) per test
+void run_prefetcher_suite(void* buffer, size_t size, double* results) {
+    const size_t strides[] = {128, 256, 512, 4096};
+    int r = 0;
+    
+    results[r++] = (double)size * ITERATIONS / (1024.0 * 1024.0 * 1024.0) /
+                   test_sequential_read(buffer, size, ITERATIONS);
+    results[r++] = (double)size * ITERATIONS / (1024.0 * 1024.0 * 1024.0) /
+                   test_sequential_write(buffer, size, ITERATIONS);
+    for (int i = 0; i < 4; i++) {
+        // Count whole cache lines fetched, one per access
+        double t = test_strided_read(buffer, size, strides[i], ITERATIONS);
+        results[r++] = (double)(size / strides[i]) * 64 * ITERATIONS / (1024.0 * 1024.0 * 1024.0) / t;
+    }
+    double t = test_random_read(buffer, size, ITERATIONS);
+    results[r++] = t > 0 ? (double)RANDOM_ACCESSES * ITERATIONS / t / 1e6 : 0.0;
+    t = test_random_write(buffer, size, ITERATIONS);
+    results[r++] = t > 0 ? (double)RANDOM_ACCESSES * ITERATIONS / t / 1e6 : 0.0;
+    t = test_memory_latency(buffer, size, LATENCY_ACCESSES);
+    results[r++] = t > 0 ? t * 1e9 / LATENCY_ACCESSES : 0.0;
+}
+
+void run_msr_prefetch_tests(size_t size) {
+    printf("\nRunning hardware prefetcher on/off comparison...\n");
+    const char* reason = msr_prefetch_open();
+    if (reason) {
+        printf("Skipped: %s\n", reason);
+        return;
+    }
+    printf("%s prefetcher MSR 0x%X, disable mask 0x%llX, %d CPUs, %zu MB buffer\n",
+           msr_state.vendor, msr_state.msr, (unsigned long long)msr_state.disable_bits,
+           msr_state.num_cpus, size / (1024 * 1024));
+    
+    void* buffer = aligned_malloc(64, size);
+    if (!buffer) {
+        fprintf(stderr, "Failed to allocate prefetcher test buffer\n");
+        msr_prefetch_close();
+        return;
+    }
+    memset(buffer, 0xAA, size);
+    
+    double on[MSR_SUITE_TESTS], off[MSR_SUITE_TESTS];
+    run_prefetcher_suite(buffer, size, on);  // Warmup so both measured runs start from the same state
+    run_prefetcher_suite(buffer, size, on);
+    
+    void (*old_int)(int) = signal(SIGINT, msr_prefetch_signal_handler);
+    void (*old_term)(int) = signal(SIGTERM, msr_prefetch_signal_handler);
+    atexit(msr_prefetch_restore);
+    if (!msr_prefetch_disable()) {
+        printf("Skipped: writing the prefetcher MSR failed\n");
+    } else {
+        run_prefetcher_suite(buffer, size, off);
+        msr_prefetch_restore();
+        
+        const char* names[MSR_SUITE_TESTS] = {
+            "Sequential Read", "Sequential Write", "Stride 128B Read", "Stride 256B Read",
+            "Stride 512B Read", "Stride 4KB Read", "Random Read", "Random Write", "Latency (chase)"
+        };
+        const char* units[MSR_SUITE_TESTS] = {
+            "GB/s", "GB/s", "GB/s", "GB/s", "GB/s", "GB/s", "MIOPS", "MIOPS", "ns"
+        };
+        printf("%-20s %14s %14s %10s\n", "Test", "Prefetch On", "Prefetch Off", "Delta");
+        printf("--------------------------------------------------------------------------------\n");
+        for (int i = 0; i < MSR_SUITE_TESTS; i++) {
+            printf("%-20s %8.3f %-5s %8.3f %-5s %+9.1f%%\n", names[i], on[i], units[i], off[i], units[i],
+                   on[i] > 0 ? 100.0 * (off[i] - on[i]) / on[i] : 0.0);
+        }
+        // GB/s and ns rows go to the results store; MIOPS rows have no series there
+        for (int state = 0; state < 2; state++) {
+            const double* values = state ? off : on;
+            snprintf(record_case, sizeof(record_case), "prefetch %s", state ? "off" : "on");
+            for (int i = 0; i < MSR_SUITE_TESTS; i++) {
+                if (strcmp(units[i], "GB/s") == 0) record_bandwidth(names[i], values[i]);
+                else if (strcmp(units[i], "ns") == 0) record_latency(names[i], size, values[i]);
+            }
+        }
+        record_case[0] = '\0';
+        printf("Prefetcher MSRs restored to their original values\n");
+    }
+    signal(SIGINT, old_int);
+    signal(SIGTERM, old_term);
+    
+    free(buffer);
+    msr_prefetch_close();
+}
+
+// ---------------------------------------------------------------------------
+// LLC inclusivity: inclusive, non-inclusive or exclusive (victim) last level
+// ---------------------------------------------------------------------------
+
+const char* llc_inclusivity_name(llc_inclusivity_t value) {
+    switch (value) {
+    case LLC_INCLUSIVE:     return "inclusive";
+    case LLC_NON_INCLUSIVE: return "non-inclusive";
+    case LLC_EXCLUSIVE:     return "exclusive (victim)";
+    default:                return "unknown";
+    }
+}
+
+// Inclusive bit (EDX bit 1) of the deterministic cache parameters for `level`,
+// from leaf 4 on Intel or 0x8000001D on AMD. Returns 1, 0, or -1 if unavailable.
+int cpuid_cache_inclusive(int level) {
+#ifdef HAVE_X86_INTRINSICS
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int leaf = 4;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return -1;
+    unsigned int max_leaf = eax;
+    if (ebx == 0x68747541) {  // "AuthenticAMD": needs the topology extensions bit
+        if (__get_cpuid_max(0x80000000, NULL) < 0x8000001D) return -1;
+        __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx);
+        if (!(ecx & (1u << 22))) return -1;
+        leaf = 0x8000001D;
+    } else if (max_leaf < 4) {
+        return -1;
+    }
+    for (unsigned int sub = 0; sub < 16; sub++) {
+        __cpuid_count(leaf, sub, eax, ebx, ecx, edx);
+        unsigned int type = eax & 0x1F;  // 0 = no more caches, 2 = instruction
+        if (type == 0) break;
+        if (type != 2 && (int)((eax >> 5) & 0x7) == level) return (edx >> 1) & 1;
+    }
+#else
+    (void)level;
+#endif
+    return -1;
+}
+
+typedef enum { BACKINVAL_WARM, BACKINVAL_EVICT, BACKINVAL_FLUSH } backinval_mode_t;
+
+typedef struct {
+    void* chain;           // Pointer chain sized to fit the owner core's L2
+    size_t chain_size;
+    void* evict_buffer;    // Streamed by the neighbour core to cycle the LLC
+    size_t evict_size;
+    int owner_cpu;
+    int evict_cpu;
+    backinval_mode_t mode;
+    double reprobe_ns;     // Latency of one pass over the chain afterwards
+} backinval_args_t;
+
+// Thread 0 owns an L2-resident chain; thread 1, on another core sharing the
+// LLC, streams enough data to evict it from the LLC. If the LLC is inclusive
+// the owner's L2 copies are back-invalidated and the re-chase goes to DRAM.
+void backinval_worker(thread_ctx_t* ctx) {
+    backinval_args_t* args = (backinval_args_t*)ctx->shared;
+    size_t lines = args->chain_size / 64;
+    
+    if (ctx->thread_id == 0) {
+        pin_thread_to_cpu(args->owner_cpu);
+        chase_pointer_chain(args->chain, lines * 3);
+        if (args->mode == BACKINVAL_FLUSH) flush_buffer(args->chain, args->chain_size);
+        thread_timed_begin(ctx);
+        pthread_barrier_wait(ctx->barrier);  // Neighbour streams in between
+        args->reprobe_ns = chase_pointer_chain(args->chain, lines) * 1e9 / lines;
+        thread_timed_end(ctx);
+    } else {
+        pin_thread_to_cpu(args->evict_cpu);
+        uint64_t sum = 0;
+        thread_timed_begin(ctx);
+        if (args->mode == BACKINVAL_EVICT) {
+            sum += aggressor_pass(AGGRESSOR_LOADS, args->evict_buffer, args->evict_size);
+            sum += aggressor_pass(AGGRESSOR_LOADS, args->evict_buffer, args->evict_size);
+        }
+        pthread_barrier_wait(ctx->barrier);
+        thread_timed_end(ctx);
+        ctx->sink = sum;
+    }
+}
+
+int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Median re-chase latency over INCLUSIVITY_TRIALS runs of one mode, or -1 on error
+double run_backinval_mode(backinval_args_t* args, backinval_mode_t mode) {
+    double samples[INCLUSIVITY_TRIALS];
+    args->mode = mode;
+    for (int t = 0; t < INCLUSIVITY_TRIALS; t++) {
+        if (run_threaded(2, backinval_worker, args, NULL) < 0) return -1.0;
+        samples[t] = args->reprobe_ns;
+    }
+    qsort(samples, INCLUSIVITY_TRIALS, sizeof(double), compare_double);
+    return samples[INCLUSIVITY_TRIALS / 2];
+}
+
+// Fraction of the owner's lines that survived LLC eviction (1 = all stayed in
+// L2, 0 = all back-invalidated), or -1 if the probe cannot run here
+double probe_back_invalidation(size_t l2, size_t l3) {
+    int owner_cpu = sched_getcpu();
+    if (owner_cpu < 0) owner_cpu = 0;
+    int evict_cpu = find_llc_neighbor_cpu(owner_cpu);
+    if (evict_cpu == owner_cpu) {
+        printf("%-34s skipped (needs a second CPU sharing the LLC)\n", "Back-invalidation probe:");
+        return -1.0;
+    }
+    
+    backinval_args_t args = {0};
+    args.chain_size = l2 / 2;
+    args.evict_size = l3 * 2;
+    args.owner_cpu = owner_cpu;
+    args.evict_cpu = evict_cpu;
+    args.chain = aligned_malloc(64, args.chain_size);
+    args.evict_buffer = aligned_malloc(64, args.evict_size);
+    if (!args.chain || !args.evict_buffer || !build_pointer_chain(args.chain, args.chain_size)) {
+        fprintf(stderr, "Failed to allocate back-invalidation buffers\n");
+        free(args.chain);
+        free(args.evict_buffer);
+        return -1.0;
+    }
+    memset(args.evict_buffer, 0x5A, args.evict_size);
+    
+    double warm_ns = run_backinval_mode(&args, BACKINVAL_WARM);
+    double evict_ns = run_backinval_mode(&args, BACKINVAL_EVICT);
+    double flush_ns = run_backinval_mode(&args, BACKINVAL_FLUSH);
+    free(args.chain);
+    free(args.evict_buffer);
+    if (warm_ns <= 0 || evict_ns <= 0 || flush_ns <= warm_ns) return -1.0;
+    
+    printf("%-34s CPU %d owns %zu KB, CPU %d streams %zu MB\n", "Back-invalidation probe:",
+           owner_cpu, args.chain_size / 1024, evict_cpu, args.evict_size / (1024 * 1024));
+    printf("  %-32s %8.1f ns/access\n", "Re-chase, no eviction", warm_ns);
+    printf("  %-32s %8.1f ns/access\n", "Re-chase after LLC eviction", evict_ns);
+    printf("  %-32s %8.1f ns/access\n", "Re-chase after clflush", flush_ns);
+    
+    double survived = (flush_ns - evict_ns) / (flush_ns - warm_ns);
+    if (survived < 0.0) survived = 0.0;
+    if (survived > 1.0) survived = 1.0;
+    return survived;
+}
+
+// Where does a working set between the LLC and L2+LLC sit? Returns the
+// fraction of the way from LLC-resident to DRAM latency (0 = the inner level
+// adds capacity, 1 = it does not), or -1 if L2 is too small to tell
+double probe_aggregate_capacity(size_t l2, size_t l3) {
+    if (l2 * 10 < l3) {
+        printf("%-34s undetermined (L2 is only %.0f%% of the LLC)\n", "Aggregate capacity probe:",
+               100.0 * l2 / l3);
+        return -1.0;
+    }
+    double fits_ns = measure_chase_ns(l3 * 3 / 4);
+    double aggregate_ns = measure_chase_ns(l3 + l2 * 3 / 4);
+    double dram_ns = measure_chase_ns(l3 * 2 + l2 * 2);
+    if (fits_ns <= 0 || aggregate_ns <= 0 || dram_ns <= fits_ns) return -1.0;
+    
+    printf("%-34s\n", "Aggregate capacity probe:");
+    printf("  %-32s %8.1f ns/access\n", "0.75 x LLC", fits_ns);
+    printf("  %-32s %8.1f ns/access\n", "LLC + 0.75 x L2", aggregate_ns);
+    printf("  %-32s %8.1f ns/access\n", "2 x (LLC + L2)", dram_ns);
+    
+    double position = (aggregate_ns - fits_ns) / (dram_ns - fits_ns);
+    return position < 0.0 ? 0.0 : position;
+}
+
+// Classify the LLC and record the result for analyze_cache_level
+void run_inclusivity_tests(void) {
+    size_t l2 = find_cache_size(2, 0);
+    size_t l3 = find_cache_size(3, 0);
+    
+    printf("\nRunning LLC inclusivity probes...\n");
+    if (!l2 || !l3) {
+        printf("Skipped: needs both L2 and L3 sizes from /sys/devices/system/cpu/\n");
+        return;
+    }
+    printf("--------------------------------------------------------------------------------\n");
+    
+    int cpuid_bit = cpuid_cache_inclusive(3);
+    printf("%-34s %s\n", "CPUID L3 inclusive bit:",
+           cpuid_bit < 0 ? "not reported" : cpuid_bit ? "set (inclusive)" : "clear (not inclusive)");
+    
+    // The back-invalidation owner runs on thread 0, which is this thread
+    cpu_set_t saved_affinity;
+    pthread_getaffinity_np(pthread_self(), sizeof(saved_affinity), &saved_affinity);
+    double survived = probe_back_invalidation(l2, l3);
+    pthread_setaffinity_np(pthread_self(), sizeof(saved_affinity), &saved_affinity);
+    double position = probe_aggregate_capacity(l2, l3);
+    
+    const char* source = "measured";
+    llc_inclusivity = LLC_UNKNOWN;
+    if (survived >= 0 && survived < 0.3) {
+        llc_inclusivity = LLC_INCLUSIVE;
+    } else if (position >= 0 && position < 0.25) {
+        llc_inclusivity = LLC_EXCLUSIVE;
+    } else if (survived > 0.7) {
+        llc_inclusivity = LLC_NON_INCLUSIVE;
+    } else if (survived < 0 && position < 0 && cpuid_bit >= 0) {
+        llc_inclusivity = cpuid_bit ? LLC_INCLUSIVE : LLC_NON_INCLUSIVE;
+        source = "CPUID only";
+    }
+    
+    llc_effective_bytes = llc_inclusivity == LLC_EXCLUSIVE ? l3 + l2 : l3;
+    
+    printf("--------------------------------------------------------------------------------\n");
+    if (survived >= 0) {
+        printf("%-34s %.0f%% of L2 lines kept after LLC eviction\n", "Back-invalidation:", 100.0 * survived);
+    }
+    if (position >= 0) {
+        printf("%-34s LLC + 0.75 x L2 is %.0f%% of the way to DRAM latency\n", "Aggregate capacity:",
+               100.0 * position);
+    }
+    if (llc_inclusivity == LLC_UNKNOWN) {
+        printf("%-34s undetermined\n", "L3 inclusivity:");
+    } else {
+        printf("%-34s %s (%s)\n", "L3 inclusivity:", llc_inclusivity_name(llc_inclusivity), source);
+    }
+    printf("%-34s %zu KB per core\n", "Effective on-chip capacity:", llc_effective_bytes / 1024);
+}
+
+// ---------------------------------------------------------------------------
+// Replacement policy: cyclic, reverse and scan-mixed patterns against LRU
+// ---------------------------------------------------------------------------
+
+typedef enum { REPLACEMENT_CYCLIC, REPLACEMENT_REVERSE, REPLACEMENT_MIXED } replacement_pattern_t;
+
+const char* replacement_pattern_name(replacement_pattern_t pattern) {
+    switch (pattern) {
+    case REPLACEMENT_CYCLIC:  return "cyclic";
+    case REPLACEMENT_REVERSE: return "reverse";
+    case REPLACEMENT_MIXED:   return "hot + scan";
+    default:                  return "unknown";
+    }
+}
+
+// One period of `pattern` over a set with `ways` ways, as line ids in `seq`
+// (room for 3 * ways + 4 entries). Returns the period length; the number of
+// distinct lines goes to *num_lines.
+//  cyclic:  ways + ways/4 lines in a loop, every access misses under LRU
+//  reverse: the same lines forward then backward, LRU keeps the turn-around lines
+//  mixed:   ways/2 hot lines re-read between two scans of `ways` lines each;
+//           LRU loses the hot lines too, a scan-resistant policy keeps them
+size_t replacement_sequence(replacement_pattern_t pattern, size_t ways, uint32_t* seq, size_t* num_lines) {
+    size_t len = 0;
+    size_t extra = ways / 4 > 0 ? ways / 4 : 1;
+    size_t hot = ways / 2 > 0 ? ways / 2 : 1;
+    
+    switch (pattern) {
+    case REPLACEMENT_CYCLIC:
+        *num_lines = ways + extra;
+        for (size_t i = 0; i < *num_lines; i++) seq[len++] = i;
+        break;
+    case REPLACEMENT_REVERSE:
+        *num_lines = ways + extra;
+        for (size_t i = 0; i < *num_lines; i++) seq[len++] = i;
+        for (size_t i = *num_lines; i-- > 0;) seq[len++] = i;
+        break;
+    case REPLACEMENT_MIXED:
+        *num_lines = hot + 2 * ways;
+        for (size_t round = 0; round < 2; round++) {
+            for (size_t i = 0; i < hot; i++) seq[len++] = i;
+            for (size_t i = 0; i < ways; i++) seq[len++] = hot + round * ways + i;
+        }
+        break;
+    }
+    return len;
+}
+
+// Link the sequence into a pointer chain: the k-th visit of a line in the
+// period uses the k-th 8-byte word of that line, so lines may repeat. Line `id`
+// lives at base + line_offset[id], and seq[0] must be at offset 0.
+int build_sequence_chain(char* base, const size_t* line_offset, size_t num_lines,
+                         const uint32_t* seq, size_t len) {
+    uint8_t* visits = calloc(num_lines, 1);
+    size_t* nodes = malloc(len * sizeof(size_t));
+    if (!visits || !nodes) {
+        free(visits);
+        free(nodes);
+        return 0;
+    }
+    int ok = line_offset[seq[0]] == 0;
+    for (size_t i = 0; i < len && ok; i++) {
+        uint32_t line = seq[i];
+        if (visits[line] >= REPLACEMENT_MAX_SLOTS) ok = 0;
+        else nodes[i] = line_offset[line] + (size_t)visits[line]++ * sizeof(size_t);
+    }
+    for (size_t i = 0; i < len && ok; i++) {
+        *(size_t*)(base + nodes[i]) = nodes[(i + 1) % len];
+    }
+    free(visits);
+    free(nodes);
+    return ok;
+}
+
+// Hit rate of an ideal LRU cache with `ways` ways over the second of two
+// periods. Each access hits if fewer than `ways` distinct lines were touched
+// since its previous use; the count comes from a Fenwick tree over time that
+// marks each line's latest access.
+double lru_model_hit_rate(const uint32_t* seq, size_t len, size_t num_lines, size_t ways) {
+    size_t total = len * 2;
+    uint32_t* tree = calloc(total + 1, sizeof(uint32_t));
+    int64_t* last = malloc(num_lines * sizeof(int64_t));
+    if (!tree || !last) {
+        free(tree);
+        free(last);
+        return -1.0;
+    }
+    for (size_t i = 0; i < num_lines; i++) last[i] = -1;
+    
+    size_t hits = 0;
+    for (size_t t = 0; t < total; t++) {
+        uint32_t line = seq[t % len];
+        if (last[line] >= 0) {
+            // Marked positions in (last, t): distinct lines touched in between
+            size_t distinct = 0;
+            for (size_t k = t; k > 0; k -= k & -k) distinct += tree[k];
+            for (size_t k = (size_t)last[line] + 1; k > 0; k -= k & -k) distinct -= tree[k];
+            if (distinct < ways && t >= len) hits++;
+            for (size_t k = (size_t)last[line] + 1; k <= total; k += k & -k) tree[k]--;
+        }
+        for (size_t k = t + 1; k <= total; k += k & -k) tree[k]++;
+        last[line] = (int64_t)t;
+    }
+    free(tree);
+    free(last);
+    return (double)hits / len;
+}
+
+typedef struct {
+    const char* name;
+    char* base;                 // Buffer holding the probed lines
+    size_t* line_offset;        // Offset of each line id, all mapping to one set when per-set
+    size_t max_lines;
+    size_t ways;                // Ways of the set, or lines of the whole cache
+    double hit_ns;              // Chase latency when the level holds everything
+    double miss_ns;             // Chase latency from the next level out, 0 to measure it in the set
+} replacement_level_t;
+
+// Miss latency with the same set and page geometry as the probes: a shuffled
+// loop over REPLACEMENT_MISS_FACTOR x ways lines of one set, which no policy
+// can hit more than 1/REPLACEMENT_MISS_FACTOR of the time
+double replacement_miss_ns(const replacement_level_t* lv) {
+    size_t len = lv->ways * REPLACEMENT_MISS_FACTOR;
+    if (len > lv->max_lines) return -1.0;
+    uint32_t* seq = malloc(len * sizeof(uint32_t));
+    if (!seq) return -1.0;
+    for (size_t i = 0; i < len; i++) seq[i] = i;
+    for (size_t i = len - 1; i > 1; i--) {
+        size_t j = 1 + (size_t)((unsigned long long)rand() * i / (RAND_MAX + 1ULL));
+        uint32_t tmp = seq[i];
+        seq[i] = seq[j];
+        seq[j] = tmp;
+    }
+    double ns = -1.0;
+    if (build_sequence_chain(lv->base, lv->line_offset, len, seq, len)) {
+        size_t accesses = len * ((LATENCY_ACCESSES / 4 + len - 1) / len);
+        chase_pointer_chain(lv->base, len * 2);
+        ns = chase_pointer_chain(lv->base, accesses) * 1e9 / accesses;
+    }
+    free(seq);
+    return ns;
+}
+
+// Measured and modeled hit rate for one pattern; returns 0 if it cannot run
+int run_replacement_pattern(const replacement_level_t* lv, replacement_pattern_t pattern,
+                            double* measured, double* modeled, double* latency_ns, size_t* lines_out) {
+    uint32_t* seq = malloc((3 * lv->ways + 4) * sizeof(uint32_t));
+    if (!seq) return 0;
+    size_t num_lines;
+    size_t len = replacement_sequence(pattern, lv->ways, seq, &num_lines);
+    if (num_lines > lv->max_lines || !build_sequence_chain(lv->base, lv->line_offset, num_lines, seq, len)) {
+        free(seq);
+        return 0;
+    }
+    
+    // Whole periods only, at least LATENCY_ACCESSES / 4 accesses
+    size_t accesses = len * ((LATENCY_ACCESSES / 4 + len - 1) / len);
+    chase_pointer_chain(lv->base, len * 2);
+    *latency_ns = chase_pointer_chain(lv->base, accesses) * 1e9 / accesses;
+    *measured = (lv->miss_ns - *latency_ns) / (lv->miss_ns - lv->hit_ns);
+    if (*measured < 0.0) *measured = 0.0;
+    if (*measured > 1.0) *measured = 1.0;
+    *modeled = lru_model_hit_rate(seq, len, num_lines, lv->ways);
+    *lines_out = num_lines;
+    free(seq);
+    return 1;
+}
+
+void run_replacement_level(replacement_level_t* lv) {
+    if (lv->miss_ns <= 0) lv->miss_ns = replacement_miss_ns(lv);
+    if (lv->miss_ns <= lv->hit_ns) {
+        printf("%-8s %-12s skipped (no miss latency reference)\n", lv->name, "all");
+        return;
+    }
+    const replacement_pattern_t patterns[] = {REPLACEMENT_CYCLIC, REPLACEMENT_REVERSE, REPLACEMENT_MIXED};
+    double measured[3] = {0}, modeled[3] = {0};
+    int ran[3] = {0};
+    
+    for (int p = 0; p < 3; p++) {
+        double latency_ns;
+        size_t lines;
+        ran[p] = run_replacement_pattern(lv, patterns[p], &measured[p], &modeled[p], &latency_ns, &lines);
+        if (!ran[p]) {
+            printf("%-8s %-12s skipped (buffer too small)\n", lv->name, replacement_pattern_name(patterns[p]));
+            continue;
+        }
+        printf("%-8s %-12s %10zu %8.1f ns/access %11.1f%% %11.1f%%\n", lv->name,
+               replacement_pattern_name(patterns[p]), lines, latency_ns,
+               100.0 * measured[p], 100.0 * modeled[p]);
+        snprintf(record_case, sizeof(record_case), "%s", lv->name);
+        record_latency(replacement_pattern_name(patterns[p]), lines * 64, latency_ns);
+        record_case[0] = '\0';
+    }
+    if (!ran[0] || !ran[1] || !ran[2]) return;
+    
+    // Cyclic and mixed patterns give LRU no hits, so any hits there come from the policy
+    printf("%-8s loops: %s; scans: %s; order: %s\n", "",
+           measured[0] > 0.2 ? "thrash-resistant" : "thrash like LRU",
+           measured[2] > modeled[2] + 0.15 ? "hot lines survive" : "hot lines evicted",
+           fabs(measured[1] - modeled[1]) < 0.15 ? "LRU-like" : "not LRU (pseudo-LRU, random or RRIP)");
+}
+
+void run_replacement_tests(void) {
+    size_t l1 = find_cache_size(1, KB_TO_BYTES(32));
+    size_t l2 = find_cache_size(2, KB_TO_BYTES(256));
+    size_t l3 = find_cache_size(3, 0);
+    int l1_ways = find_cache_ways(1, 8);
+    int l2_ways = find_cache_ways(2, 8);
+    
+    printf("\nRunning cache replacement policy tests...\n");
+    double l1_ns = measure_chase_ns(l1 / 2);
+    double l2_ns = measure_chase_ns(l2 / 2);
+    double l3_ns = l3 ? measure_chase_ns(l3 / 2) : -1.0;
+    printf("Hit rate = (miss latency - measured) / (miss latency - hit latency); per-set misses use a %dx-ways loop\n",
+           REPLACEMENT_MISS_FACTOR);
+    printf("%-8s %-12s %10s %-20s %12s %12s\n", "Level", "Pattern", "Lines", "Latency", "Hit Rate", "LRU Model");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    // L1: lines one set stride apart share a set, and the index bits are inside the page offset
+    size_t l1_stride = l1 / l1_ways;
+    size_t l1_lines = (size_t)l1_ways * REPLACEMENT_MISS_FACTOR;
+    char* l1_buffer = aligned_malloc(4096, l1_lines * l1_stride);
+    size_t* offsets = malloc(l1_lines * sizeof(size_t));
+    if (l1_buffer && offsets) {
+        for (size_t i = 0; i < l1_lines; i++) offsets[i] = i * l1_stride;
+        replacement_level_t lv = {"L1", l1_buffer, offsets, l1_lines, l1_ways, l1_ns, 0};
+        run_replacement_level(&lv);
+    }
+    free(l1_buffer);
+    free(offsets);
+    
+    // L2: the set stride spans pages, so the lines must come from 2 MB hugepages
+    size_t l2_stride = l2 / l2_ways;
+    size_t l2_lines = (size_t)l2_ways * REPLACEMENT_MISS_FACTOR;
+    size_t l2_bytes = (l2_lines * l2_stride + HUGEPAGE_SIZE - 1) / HUGEPAGE_SIZE * HUGEPAGE_SIZE;
+    char* l2_buffer = HUGEPAGE_SIZE % l2_stride == 0
+        ? mmap(NULL, l2_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0)
+        : MAP_FAILED;
+    offsets = malloc(l2_lines * sizeof(size_t));
+    if (l2_buffer != MAP_FAILED && offsets) {
+        for (size_t i = 0; i < l2_lines; i++) offsets[i] = i * l2_stride;
+        replacement_level_t lv = {"L2", l2_buffer, offsets, l2_lines, l2_ways, l2_ns, 0};
+        run_replacement_level(&lv);
+    } else {
+        printf("%-8s %-12s skipped (needs %zu free 2 MB hugetlb pages, see /proc/sys/vm/nr_hugepages)\n",
+               "L2", "all", l2_bytes / HUGEPAGE_SIZE);
+    }
+    if (l2_buffer != MAP_FAILED) munmap(l2_buffer, l2_bytes);
+    free(offsets);
+    
+    // LLC: sets are hashed across slices, so probe the whole cache as one
+    // fully associative set with lines in shuffled order
+    if (l3) {
+        size_t ways = l3 / 64;
+        size_t lines = 3 * ways + 4;
+        char* buffer = aligned_malloc(64, lines * 64);
+        offsets = malloc(lines * sizeof(size_t));
+        if (buffer && offsets) {
+            for (size_t i = 0; i < lines; i++) offsets[i] = i * 64;
+            for (size_t i = lines - 1; i > 1; i--) {
+                size_t j = 1 + (size_t)((unsigned long long)rand() * i / (RAND_MAX + 1ULL));
+                size_t tmp = offsets[i];
+                offsets[i] = offsets[j];
+                offsets[j] = tmp;
+            }
+            replacement_level_t lv = {"L3", buffer, offsets, lines, ways, l3_ns, measure_chase_ns(l3 * 4)};
+            run_replacement_level(&lv);
+        } else {
+            fprintf(stderr, "Failed to allocate LLC replacement buffer\n");
+        }
+        free(buffer);
+        free(offsets);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Coherence: latency of reading lines another core holds in M, E or S state
+// ---------------------------------------------------------------------------
+
+typedef enum { CPU_SMT_SIBLING, CPU_SAME_L3, CPU_OTHER_L3, CPU_REMOTE_SOCKET, CPU_DISTANCE_COUNT } cpu_distance_t;
+
+const char* cpu_distance_name(cpu_distance_t distance) {
+    switch (distance) {
+    case CPU_SMT_SIBLING:   return "SMT sibling";
+    case CPU_SAME_L3:       return "same L3";
+    case CPU_OTHER_L3:      return "other L3";
+    case CPU_REMOTE_SOCKET: return "remote socket";
+    default:                return "unknown";
+    }
+}
+
+// Integer from /sys/devices/system/cpu/cpu<cpu>/<name>, or -1 if unavailable
+int read_cpu_sysfs_int(int cpu, const char* name) {
+    char path[256];
+    char buffer[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/%s", cpu, name);
+    FILE* fp = fopen(path, "r");
+    if (!fp) return -1;
+    int value = -1;
+    if (fgets(buffer, sizeof(buffer), fp)) value = atoi(buffer);
+    fclose(fp);
+    return value;
+}
+
+// How far apart two CPUs are in the cache topology
+cpu_distance_t classify_cpu_pair(int a, int b) {
+    static int cpus[MAX_CPUS];
+    char path[256];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", a);
+    int count = read_cpu_list_file(path, cpus, MAX_CPUS);
+    if (cpu_in_list(b, cpus, count)) return CPU_SMT_SIBLING;
+    if (read_cpu_sysfs_int(a, "topology/physical_package_id") !=
+        read_cpu_sysfs_int(b, "topology/physical_package_id")) {
+        return CPU_REMOTE_SOCKET;
+    }
+    count = read_cache_shared_cpus(a, 3, cpus, MAX_CPUS);
+    return cpu_in_list(b, cpus, count) ? CPU_SAME_L3 : CPU_OTHER_L3;
+}
+
+typedef enum {
+    COHERENCE_MODIFIED,
+    COHERENCE_EXCLUSIVE,
+    COHERENCE_SHARED,
+    COHERENCE_LOCAL,     // Reader already holds the lines
+    COHERENCE_FLUSHED,   // Nobody holds them: memory latency
+    COHERENCE_STATE_COUNT
+} coherence_state_t;
+
+typedef struct {
+    void* chain;
+    size_t size;
+    int cpus[3];                 // Reader, owner, sharer
+    coherence_state_t state;
+    double latency_ns;
+} coherence_args_t;
+
+// Thread 0 is the reader, thread 1 the owner and thread 2 (shared state only)
+// the second sharer. After a flush the owner writes (M) or reads (E) the lines,
+// the sharer reads them too (S), and then the reader chases them once.
+void coherence_worker(thread_ctx_t* ctx) {
+    coherence_args_t* args = (coherence_args_t*)ctx->shared;
+    volatile uint64_t* data = (volatile uint64_t*)args->chain;
+    size_t lines = args->size / 64;
+    uint64_t sum = 0;
+    
+    pin_thread_to_cpu(args->cpus[ctx->thread_id]);
+    if (ctx->thread_id == 0) flush_buffer(args->chain, args->size);
+    pthread_barrier_wait(ctx->barrier);
+    
+    int owner_reads = args->state == COHERENCE_EXCLUSIVE || args->state == COHERENCE_SHARED;
+    if ((ctx->thread_id == 1 && owner_reads) || (ctx->thread_id == 0 && args->state == COHERENCE_LOCAL)) {
+        for (size_t i = 0; i < lines; i++) sum += data[i * 8];
+    } else if (ctx->thread_id == 1 && args->state == COHERENCE_MODIFIED) {
+        for (size_t i = 0; i < lines; i++) data[i * 8 + 1] = i;  // Word 0 holds the chain pointer
+    }
+    pthread_barrier_wait(ctx->barrier);
+    
+    if (ctx->thread_id == 2) {
+        for (size_t i = 0; i < lines; i++) sum += data[i * 8];
+    }
+    thread_timed_begin(ctx);
+    if (ctx->thread_id == 0) {
+        args->latency_ns = chase_pointer_chain(args->chain, lines) * 1e9 / lines;
+    }
+    thread_timed_end(ctx);
+    ctx->sink = sum;
+}
+
+// Median latency over COHERENCE_TRIALS runs, or -1 if the state cannot be set up
+double run_coherence_state(coherence_args_t* args, coherence_state_t state) {
+    double samples[COHERENCE_TRIALS];
+    int threads = state == COHERENCE_SHARED ? 3 : 2;
+    if (state == COHERENCE_SHARED && args->cpus[2] < 0) return -1.0;
+    args->state = state;
+    for (int t = 0; t < COHERENCE_TRIALS; t++) {
+        if (run_threaded(threads, coherence_worker, args, NULL) < 0) return -1.0;
+        samples[t] = args->latency_ns;
+    }
+    qsort(samples, COHERENCE_TRIALS, sizeof(double), compare_double);
+    return samples[COHERENCE_TRIALS / 2];
+}
+
+void run_coherence_tests(void) {
+    static int online[MAX_CPUS];
+    int num_online = read_cpu_list_file("/sys/devices/system/cpu/online", online, MAX_CPUS);
+    int owner = sched_getcpu();
+    if (owner < 0) owner = 0;
+    
+    printf("\nRunning coherence state latency tests (%d lines, owner CPU %d)...\n", COHERENCE_LINES, owner);
+    if (num_online < 2) {
+        printf("Skipped: needs at least two online CPUs\n");
+        return;
+    }
+    
+    coherence_args_t args = {0};
+    args.size = (size_t)COHERENCE_LINES * 64;
+    args.chain = aligned_malloc(64, args.size);
+    if (!args.chain || !build_pointer_chain(args.chain, args.size)) {
+        fprintf(stderr, "Failed to set up coherence test chain\n");
+        free(args.chain);
+        return;
+    }
+    
+    cpu_set_t saved_affinity;
+    pthread_getaffinity_np(pthread_self(), sizeof(saved_affinity), &saved_affinity);
+    
+    static const char* state_names[COHERENCE_STATE_COUNT] = {"Modified", "Exclusive", "Shared", "Local", "Memory"};
+    printf("%-16s %-14s %9s %9s %9s %9s %9s\n", "Owner -> Reader", "Distance",
+           state_names[0], state_names[1], state_names[2], state_names[3], state_names[4]);
+    printf("--------------------------------------------------------------------------------\n");
+    
+    for (int d = 0; d < CPU_DISTANCE_COUNT; d++) {
+        int reader = -1;
+        for (int i = 0; i < num_online && reader < 0; i++) {
+            if (online[i] != owner && (int)classify_cpu_pair(owner, online[i]) == d) reader = online[i];
+        }
+        if (reader < 0) continue;
+        
+        // Prefer a sharer close to the owner so S lines stay in the owner's L3
+        int sharer = -1;
+        for (int i = 0; i < num_online; i++) {
+            if (online[i] == owner || online[i] == reader) continue;
+            if (sharer < 0 || classify_cpu_pair(owner, online[i]) < classify_cpu_pair(owner, sharer)) {
+                sharer = online[i];
+            }
+        }
+        args.cpus[0] = reader;
+        args.cpus[1] = owner;
+        args.cpus[2] = sharer;
+        
+        char pair[32];
+        snprintf(pair, sizeof(pair), "CPU %d -> %d", owner, reader);
+        printf("%-16s %-14s", pair, cpu_distance_name((cpu_distance_t)d));
+        snprintf(record_case, sizeof(record_case), "%s", cpu_distance_name((cpu_distance_t)d));
+        for (int s = 0; s < COHERENCE_STATE_COUNT; s++) {
+            double ns = run_coherence_state(&args, (coherence_state_t)s);
+            if (ns < 0) {
+                printf(" %9s", "-");
+            } else {
+                printf(" %6.1f ns", ns);
+                record_latency(state_names[s], 64, ns);
+            }
+        }
+        printf("\n");
+        record_case[0] = '\0';
+    }
+    
+    pthread_setaffinity_np(pthread_self(), sizeof(saved_affinity), &saved_affinity);
+    free(args.chain);
+}
+
+// ---------------------------------------------------------------------------
+// DRAM row-buffer locality and bank-level parallelism
+// ---------------------------------------------------------------------------
+
+#ifdef HAVE_X86_INTRINSICS
+// Serialized timestamp reads bracketing the loads under test
+static inline uint64_t rdtsc_begin(void) {
+    _mm_mfence();
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+
+static inline uint64_t rdtsc_end(void) {
+    unsigned int aux;
+    uint64_t t = __rdtscp(&aux);
+    _mm_lfence();
+    return t;
+}
+#endif
+
+// TSC ticks per nanosecond, measured against CLOCK_MONOTONIC; 0 if unavailable
+double calibrate_tsc(void) {
+#ifdef HAVE_X86_INTRINSICS
+    double start_time = get_time();
+    uint64_t start_ticks = rdtsc_begin();
+    while (get_time() - start_time < 0.02) {
+        // Spin for 20 ms
+    }
+    uint64_t end_ticks = rdtsc_end();
+    double elapsed = get_time() - start_time;
+    return (double)(end_ticks - start_ticks) / (elapsed * 1e9);
+#else
+    return 0.0;
+#endif
+}
+
+// Physical address backing `p` from /proc/self/pagemap, or 0 if the page is
+// not present or the PFNs are hidden (they read as zero without CAP_SYS_ADMIN)
+uint64_t virt_to_phys(const void* p) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    uint64_t vaddr = (uint64_t)(uintptr_t)p;
+    uint64_t entry = 0;
+    int fd = open("/proc/self/pagemap", O_RDONLY);
+    if (fd < 0) return 0;
+    ssize_t got = pread(fd, &entry, sizeof(entry), (off_t)(vaddr / page_size * sizeof(entry)));
+    close(fd);
+    if (got != sizeof(entry) || !(entry & (1ULL << 63))) return 0;
+    uint64_t pfn = entry & ((1ULL << 55) - 1);
+    return pfn ? pfn * page_size + vaddr % page_size : 0;
+}
+
+// Map one 2 MB chunk from hugetlbfs, else a THP-advised aligned allocation.
+// *kind describes which one; unmap with free_huge_chunk.
+void* alloc_huge_chunk(size_t size, const char** kind) {
+    void* p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+        *kind = "hugetlb";
+    } else {
+        p = aligned_malloc(HUGEPAGE_SIZE, size);
+        if (!p) return NULL;
+        madvise(p, size, MADV_HUGEPAGE);
+        *kind = "THP";
+    }
+    memset(p, 0, size);
+    return p;
+}
+
+void free_huge_chunk(void* p, size_t size, const char* kind) {
+    if (strcmp(kind, "hugetlb") == 0) munmap(p, size);
+    else free(p);
+}
+
+// 1 if pagemap shows the chunk physically contiguous, 0 if not, -1 if unknown
+int chunk_is_contiguous(const char* p, size_t size) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    uint64_t base = virt_to_phys(p);
+    if (!base) return -1;
+    for (size_t off = page_size; off < size; off += page_size) {
+        if (virt_to_phys(p + off) != base + off) return 0;
+    }
+    return 1;
+}
+
+#ifdef HAVE_X86_INTRINSICS
+int compare_uint64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Median ticks for independent loads of a and b with both flushed. Lines in
+// the same bank but different rows serialize on the row buffer and take longer.
+uint64_t dram_pair_ticks(volatile uint64_t* a, volatile uint64_t* b) {
+    uint64_t samples[DRAM_ROUNDS];
+    for (int r = 0; r < DRAM_ROUNDS; r++) {
+        _mm_clflush((const void*)a);
+        _mm_clflush((const void*)b);
+        uint64_t t0 = rdtsc_begin();
+        (void)*a;
+        (void)*b;
+        samples[r] = rdtsc_end() - t0;
+    }
+    qsort(samples, DRAM_ROUNDS, sizeof(uint64_t), compare_uint64);
+    return samples[DRAM_ROUNDS / 2];
+}
+
+// Median ticks to reload `a` from DRAM right after it was read, optionally
+// with `between` read in the meantime. With nothing in between a's row is
+// still open (row hit); a same-bank line from another row closes it (row miss).
+uint64_t dram_reopen_ticks(volatile uint64_t* a, volatile uint64_t* between) {
+    uint64_t samples[DRAM_ROUNDS];
+    for (int r = 0; r < DRAM_ROUNDS; r++) {
+        _mm_clflush((const void*)a);
+        if (between) _mm_clflush((const void*)between);
+        _mm_mfence();
+        (void)*a;
+        _mm_lfence();
+        if (between) (void)*between;
+        _mm_clflush((const void*)a);
+        uint64_t t0 = rdtsc_begin();
+        (void)*a;
+        samples[r] = rdtsc_end() - t0;
+    }
+    qsort(samples, DRAM_ROUNDS, sizeof(uint64_t), compare_uint64);
+    return samples[DRAM_ROUNDS / 2];
+}
+
+// Median ticks for `count` independent flushed loads issued together
+uint64_t dram_batch_ticks(volatile uint64_t** lines, int count) {
+    uint64_t samples[DRAM_ROUNDS];
+    for (int r = 0; r < DRAM_ROUNDS; r++) {
+        for (int i = 0; i < count; i++) _mm_clflush((const void*)lines[i]);
+        uint64_t t0 = rdtsc_begin();
+        for (int i = 0; i < count; i++) (void)*lines[i];
+        samples[r] = rdtsc_end() - t0;
+    }
+    qsort(samples, DRAM_ROUNDS, sizeof(uint64_t), compare_uint64);
+    return samples[DRAM_ROUNDS / 2];
+}
+#endif
+
+void run_dram_tests(void) {
+    printf("\nRunning DRAM row-buffer and bank parallelism tests...\n");
+#ifdef HAVE_X86_INTRINSICS
+    double ticks_per_ns = calibrate_tsc();
+    const char* kind;
+    size_t size = HUGEPAGE_SIZE;
+    char* chunk = alloc_huge_chunk(size, &kind);
+    if (!chunk || ticks_per_ns <= 0) {
+        fprintf(stderr, "Failed to set up DRAM test chunk\n");
+        if (chunk) free_huge_chunk(chunk, size, kind);
+        return;
+    }
+    
+    int contiguous = chunk_is_contiguous(chunk, size);
+    uint64_t phys = virt_to_phys(chunk);
+    printf("2 MB %s chunk, TSC %.2f GHz, ", kind, ticks_per_ns);
+    if (contiguous < 0) {
+        printf("physical addresses hidden (pagemap needs CAP_SYS_ADMIN)\n");
+    } else {
+        printf("physical 0x%llx, %s\n", (unsigned long long)phys,
+               contiguous ? "contiguous" : "NOT contiguous (offsets are not physical)");
+    }
+    if (contiguous == 0 || (contiguous < 0 && strcmp(kind, "THP") == 0)) {
+        printf("Warning: without a contiguous chunk, same-bank offsets below are only approximate\n");
+    }
+    
+    // Time the base line against every candidate to find the ones sharing its bank
+    size_t candidates = size / DRAM_SCAN_STRIDE - 1;
+    uint64_t* ticks = malloc(candidates * sizeof(uint64_t));
+    uint64_t* sorted = malloc(candidates * sizeof(uint64_t));
+    if (!ticks || !sorted) {
+        fprintf(stderr, "Failed to allocate DRAM scan results\n");
+        free(ticks);
+        free(sorted);
+        free_huge_chunk(chunk, size, kind);
+        return;
+    }
+    volatile uint64_t* base = (volatile uint64_t*)chunk;
+    for (size_t i = 0; i < candidates; i++) {
+        ticks[i] = dram_pair_ticks(base, (volatile uint64_t*)(chunk + (i + 1) * DRAM_SCAN_STRIDE));
+    }
+    memcpy(sorted, ticks, candidates * sizeof(uint64_t));
+    qsort(sorted, candidates, sizeof(uint64_t), compare_uint64);
+    uint64_t median = sorted[candidates / 2];
+    uint64_t high = sorted[candidates - 1 - candidates / 200];  // 99.5th percentile
+    uint64_t threshold = median + (high - median) / 2;
+    
+    volatile uint64_t* conflicts[DRAM_BLP_LINES];
+    volatile uint64_t* spread[DRAM_BLP_LINES];
+    int num_conflicts = 0, num_spread = 0;
+    size_t total_conflicts = 0, min_offset = 0;
+    int found = high > median + median / 10;  // Require a clearly separate slow cluster
+    for (size_t i = 0; i < candidates; i++) {
+        volatile uint64_t* line = (volatile uint64_t*)(chunk + (i + 1) * DRAM_SCAN_STRIDE);
+        if (found && ticks[i] > threshold) {
+            if (!min_offset) min_offset = (i + 1) * DRAM_SCAN_STRIDE;
+            if (num_conflicts < DRAM_BLP_LINES) conflicts[num_conflicts++] = line;
+            total_conflicts++;
+        } else if (num_spread < DRAM_BLP_LINES && (i + 1) % (candidates / DRAM_BLP_LINES) == 0) {
+            spread[num_spread++] = line;
+        }
+    }
+    
+    printf("%-40s %-20s\n", "Measurement", "Latency");
+    printf("--------------------------------------------------------------------------------\n");
+    printf("%-40s %8.1f ns\n", "Pair load, typical (different bank)", median / ticks_per_ns);
+    record_latency("Pair load, different bank", size, median / ticks_per_ns);
+    if (!found) {
+        printf("%-40s %s\n", "Pair load, same bank", "no row-conflict cluster found");
+        printf("Row conflicts were not distinguishable (virtualized or closed-page memory controller?)\n");
+    } else {
+        printf("%-40s %8.1f ns   (%zu of %zu lines, ~1/%zu)\n", "Pair load, same bank other row",
+               sorted[candidates - 1 - total_conflicts / 2] / ticks_per_ns,
+               total_conflicts, candidates, candidates / (total_conflicts ? total_conflicts : 1));
+        printf("%-40s %8zu KB\n", "Smallest same-bank offset", min_offset / 1024);
+        
+        uint64_t row_hit = dram_reopen_ticks(base, NULL);
+        uint64_t row_miss = dram_reopen_ticks(base, conflicts[0]);
+        uint64_t other_bank = dram_reopen_ticks(base, spread[0]);
+        printf("%-40s %8.1f ns\n", "Reload, row still open (row hit)", row_hit / ticks_per_ns);
+        printf("%-40s %8.1f ns\n", "Reload after other-bank access", other_bank / ticks_per_ns);
+        printf("%-40s %8.1f ns\n", "Reload after same-bank access (row miss)", row_miss / ticks_per_ns);
+        record_latency("Reload, row hit", size, row_hit / ticks_per_ns);
+        record_latency("Reload, other bank", size, other_bank / ticks_per_ns);
+        record_latency("Reload, row miss", size, row_miss / ticks_per_ns);
+        printf("%-40s %8.1f ns\n", "Row miss - row hit", ((double)row_miss - (double)row_hit) / ticks_per_ns);
+        
+        if (num_conflicts >= 2 && num_spread >= 2) {
+            int count = num_conflicts < num_spread ? num_conflicts : num_spread;
+            uint64_t same_bank = dram_batch_ticks(conflicts, count);
+            uint64_t many_banks = dram_batch_ticks(spread, count);
+            printf("%-40s %8.1f ns   (%d loads)\n", "Batch, one bank", same_bank / ticks_per_ns, count);
+            printf("%-40s %8.1f ns   (%d loads)\n", "Batch, spread across banks", many_banks / ticks_per_ns, count);
+            printf("%-40s %8.2fx\n", "Bank-level parallelism", (double)same_bank / many_banks);
+            record_latency("Batch, one bank", size, same_bank / ticks_per_ns);
+            record_latency("Batch, spread across banks", size, many_banks / ticks_per_ns);
+        }
+    }
+    
+    free(ticks);
+    free(sorted);
+    free_huge_chunk(chunk, size, kind);
+#else
+    printf("Skipped: needs x86 clflush and rdtsc\n");
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Page coloring: build buffers from pages chosen by physical cache color
+// ---------------------------------------------------------------------------
+
+typedef enum { COLOR_UNCOLORED, COLOR_BALANCED, COLOR_QUARTER } color_mode_t;
+
+const char* color_mode_name(color_mode_t mode) {
+    switch (mode) {
+    case COLOR_UNCOLORED: return "uncolored";
+    case COLOR_BALANCED:  return "balanced colors";
+    case COLOR_QUARTER:   return "1/4 of colors";
+    default:              return "unknown";
+    }
+}
+
+// Build a buffer of `pages` 4 KB pages. Pages are faulted in from a larger
+// pool, their frames read from pagemap, and the chosen ones moved with mremap
+// into one virtual range: in pool order (uncolored), cycling through every
+// color (balanced), or cycling through a quarter of them. Free with munmap.
+char* alloc_colored_buffer(size_t pages, int num_colors, color_mode_t mode, int* max_per_color) {
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    int allowed = mode == COLOR_QUARTER ? (num_colors / 4 > 0 ? num_colors / 4 : 1) : num_colors;
+    size_t pool_pages = pages * PAGE_COLOR_POOL_FACTOR * (num_colors / allowed);
+    char* pool = mmap(NULL, pool_pages * page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    char* out = mmap(NULL, pages * page_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    int* colors = malloc(pool_pages * sizeof(int));
+    int* per_color = calloc(num_colors, sizeof(int));
+    if (pool == MAP_FAILED || out == MAP_FAILED || !colors || !per_color) {
+        if (pool != MAP_FAILED) munmap(pool, pool_pages * page_size);
+        if (out != MAP_FAILED) munmap(out, pages * page_size);
+        free(colors);
+        free(per_color);
+        return NULL;
+    }
+    
+    // 4 KB pages only, so frames are placed by the buddy allocator
+    madvise(pool, pool_pages * page_size, MADV_NOHUGEPAGE);
+    for (size_t i = 0; i < pool_pages; i++) {
+        pool[i * page_size] = (char)i;
+        uint64_t phys = virt_to_phys(pool + i * page_size);
+        colors[i] = phys ? (int)((phys / page_size) % num_colors) : -1;
+    }
+    
+    size_t placed = 0;
+    for (; placed < pages; placed++) {
+        size_t pick = placed;
+        if (mode != COLOR_UNCOLORED) {
+            int want = (int)(placed % allowed);
+            for (pick = 0; pick < pool_pages && colors[pick] != want; pick++) {
+            }
+            if (pick == pool_pages) break;  // Pool ran out of this color
+        }
+        if (colors[pick] >= 0) per_color[colors[pick]]++;
+        colors[pick] = -2;
+        if (mremap(pool + pick * page_size, page_size, page_size, MREMAP_MAYMOVE | MREMAP_FIXED,
+                   out + placed * page_size) == MAP_FAILED) {
+            break;
+        }
+    }
+    
+    *max_per_color = 0;
+    for (int c = 0; c < num_colors; c++) {
+        if (per_color[c] > *max_per_color) *max_per_color = per_color[c];
+    }
+    munmap(pool, pool_pages * page_size);  // Moved pages no longer belong to the pool range
+    free(colors);
+    free(per_color);
+    if (placed < pages) {
+        munmap(out, pages * page_size);
+        return NULL;
+    }
+    return out;
+}
+
+void mean_stddev(const double* values, int count, double* mean, double* stddev) {
+    double sum = 0.0, sq = 0.0;
+    for (int i = 0; i < count; i++) sum += values[i];
+    *mean = sum / count;
+    for (int i = 0; i < count; i++) sq += (values[i] - *mean) * (values[i] - *mean);
+    *stddev = count > 1 ? sqrt(sq / (count - 1)) : 0.0;
+}
+
+void run_page_color_tests(void) {
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t l2 = find_cache_size(2, KB_TO_BYTES(256));
+    int ways = find_cache_ways(2, 8);
+    int num_colors = (int)(l2 / ways / page_size);
+    size_t size = l2 * 3 / 4;
+    size_t pages = size / page_size;
+    
+    printf("\nRunning page coloring tests (%zu KB buffers, %d L2 colors, %d trials)...\n",
+           size / 1024, num_colors, PAGE_COLOR_TRIALS);
+    if (num_colors < 2) {
+        printf("Skipped: the L2 set index fits in the page offset, so every page has the same color\n");
+        return;
+    }
+    int probe = 0;
+    if (!virt_to_phys(&probe)) {
+        printf("Skipped: /proc/self/pagemap hides frame numbers (needs CAP_SYS_ADMIN)\n");
+        return;
+    }
+    
+    printf("%-16s %-26s %-26s %8s\n", "Mode", "Latency (mean +- sd)", "Read BW (mean +- sd)", "Max/Color");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    const color_mode_t modes[] = {COLOR_UNCOLORED, COLOR_BALANCED, COLOR_QUARTER};
+    for (int m = 0; m < 3; m++) {
+        double latency[PAGE_COLOR_TRIALS], bandwidth[PAGE_COLOR_TRIALS];
+        int max_per_color = 0, worst = 0, done = 0;
+        for (int t = 0; t < PAGE_COLOR_TRIALS; t++) {
+            char* buffer = alloc_colored_buffer(pages, num_colors, modes[m], &max_per_color);
+            if (!buffer) break;
+            if (max_per_color > worst) worst = max_per_color;
+            double lat = test_memory_latency(buffer, size, LATENCY_ACCESSES / 4);
+            double bw = test_sequential_read(buffer, size, PAGE_COLOR_READ_PASSES);
+            munmap(buffer, pages * page_size);
+            if (lat <= 0 || bw <= 0) break;
+            latency[done] = lat * 1e9 / (LATENCY_ACCESSES / 4);
+            bandwidth[done] = (double)size * PAGE_COLOR_READ_PASSES / (1024.0 * 1024.0 * 1024.0) / bw;
+            done++;
+        }
+        if (done < 2) {
+            printf("%-16s skipped (could not build enough colored buffers)\n", color_mode_name(modes[m]));
+            continue;
+        }
+        double lat_mean, lat_sd, bw_mean, bw_sd;
+        mean_stddev(latency, done, &lat_mean, &lat_sd);
+        mean_stddev(bandwidth, done, &bw_mean, &bw_sd);
+        printf("%-16s %6.1f +- %4.1f ns (%4.1f%%)   %6.2f +- %4.2f GB/s (%4.1f%%) %6d\n",
+               color_mode_name(modes[m]), lat_mean, lat_sd, 100.0 * lat_sd / lat_mean,
+               bw_mean, bw_sd, 100.0 * bw_sd / bw_mean, worst);
+        record_latency(color_mode_name(modes[m]), size, lat_mean);
+        record_bandwidth(color_mode_name(modes[m]), bw_mean);
+    }
+    printf("Max/Color is the most pages of one color in any trial; balanced needs %zu\n",
+           (pages + num_colors - 1) / num_colors);
+}
+
+// ---------------------------------------------------------------------------
+// Time-domain latency trace: periodic stalls hidden by averaged latency
+// ---------------------------------------------------------------------------
+
+// Timestamp after all earlier loads completed: TSC ticks on x86, else ns
+static inline uint64_t trace_timestamp(void) {
+#ifdef HAVE_X86_INTRINSICS
+    _mm_lfence();
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+// Chase a chain from build_pointer_chain, taking a timestamp every
+// hops_per_sample hops into trace[0..samples]
+void record_latency_trace(void* chain, size_t hops_per_sample, uint64_t* trace, size_t samples) {
+    char* data = (char*)chain;
+    volatile char* ptr = data;
+    trace[0] = trace_timestamp();
+    for (size_t s = 1; s <= samples; s++) {
+        for (size_t h = 0; h < hops_per_sample; h++) {
+            ptr = data + *((volatile size_t*)ptr);
+        }
+        trace[s] = trace_timestamp();
+    }
+    if ((uintptr_t)ptr == 0) printf("Unexpected ptr value\n");
+}
+
+typedef struct {
+    const char* name;
+    double min_excess_ns;        // Spikes whose excess over the median falls in
+    double max_excess_ns;        // [min, max) belong to this class
+    double window_ns;            // Longest period searched
+} spike_class_t;
+
+// Autocorrelation of an event train: histogram the lags between each event
+// and its successors within window_ns, take the shortest lag whose bin holds
+// at least half the peak count, and return the fraction of events followed by
+// another one period later (0 if nothing periodic stands out)
+double find_event_period(const double* times, size_t count, double window_ns, double* period_ns) {
+    int* hist = calloc(TRACE_LAG_BINS, sizeof(int));
+    if (!hist || count < 8) {
+        free(hist);
+        return 0.0;
+    }
+    double bin_ns = window_ns / TRACE_LAG_BINS;
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = i + 1; j < count && j <= i + TRACE_MAX_PARTNERS; j++) {
+            double lag = times[j] - times[i];
+            if (lag >= window_ns) break;
+            hist[(size_t)(lag / bin_ns)]++;
+        }
+    }
+    int peak = 0;
+    for (int b = 1; b < TRACE_LAG_BINS; b++) {
+        if (hist[b] > peak) peak = hist[b];
+    }
+    int fundamental = -1;
+    for (int b = 1; b < TRACE_LAG_BINS - 1 && fundamental < 0; b++) {
+        if (hist[b] * 2 >= peak && hist[b] >= hist[b - 1] && hist[b] >= hist[b + 1]) fundamental = b;
+    }
+    free(hist);
+    if (fundamental < 0 || peak == 0) return 0.0;
+    
+    *period_ns = (fundamental + 0.5) * bin_ns;
+    size_t followed = 0;
+    for (size_t i = 0; i + 1 < count; i++) {
+        for (size_t j = i + 1; j < count && j <= i + TRACE_MAX_PARTNERS; j++) {
+            double off = times[j] - times[i] - *period_ns;
+            if (off > 2 * bin_ns) break;
+            if (off >= -2 * bin_ns) {
+                followed++;
+                break;
+            }
+        }
+    }
+    return (double)followed / (count - 1);
+}
+
+// Name well-known periodic interrupters for a measured period
+const char* periodic_source_hint(double period_ns) {
+    double us = period_ns / 1000.0;
+    if (us >= 3.0 && us < 4.8) return "DRAM refresh (tREFI 3.9 us)";
+    if (us >= 6.5 && us < 9.0) return "DRAM refresh (tREFI 7.8 us)";
+    if (us >= 900 && us < 1100) return "timer tick (HZ=1000)";
+    if (us >= 3700 && us < 4300) return "timer tick (HZ=250)";
+    if (us >= 9500 && us < 10500) return "timer tick (HZ=100)";
+    return "unidentified";
+}
+
+void analyze_latency_trace(const uint64_t* trace, size_t samples, size_t hops, double ticks_per_ns) {
+    double* delta = malloc(samples * sizeof(double));
+    double* sorted = malloc(samples * sizeof(double));
+    double* times = malloc(samples * sizeof(double));
+    if (!delta || !sorted || !times) {
+        fprintf(stderr, "Failed to allocate trace analysis buffers\n");
+        free(delta);
+        free(sorted);
+        free(times);
+        return;
+    }
+    for (size_t i = 0; i < samples; i++) {
+        delta[i] = (double)(trace[i + 1] - trace[i]) / ticks_per_ns;
+    }
+    memcpy(sorted, delta, samples * sizeof(double));
+    qsort(sorted, samples, sizeof(double), compare_double);
+    double median = sorted[samples / 2];
+    double total = (double)(trace[samples] - trace[0]) / ticks_per_ns;
+    
+    // Median absolute deviation sets the spike threshold
+    for (size_t i = 0; i < samples; i++) sorted[i] = fabs(delta[i] - median);
+    qsort(sorted, samples, sizeof(double), compare_double);
+    double mad = sorted[samples / 2];
+    double threshold = fmax(median + 6.0 * mad, median * 1.25);
+    memcpy(sorted, delta, samples * sizeof(double));
+    qsort(sorted, samples, sizeof(double), compare_double);
+    
+    printf("%zu samples of %zu hops over %.1f ms; per hop: median %.1f ns, p99 %.1f ns, p99.99 %.1f ns, max %.1f ns\n",
+           samples, hops, total / 1e6, median / hops, sorted[(size_t)(samples * 0.99)] / hops,
+           sorted[(size_t)(samples * 0.9999)] / hops, sorted[samples - 1] / hops);
+    printf("Spike threshold: samples above %.1f ns (median %.1f ns + 6 x MAD, at least +25%%)\n", threshold, median);
+    record_latency("median", 0, median / hops);
+    record_latency("p99", 0, sorted[(size_t)(samples * 0.99)] / hops);
+    record_latency("p99.99", 0, sorted[(size_t)(samples * 0.9999)] / hops);
+    printf("%-10s %8s %12s %9s %12s %8s  %s\n", "Class", "Events", "Period", "Strength", "Amplitude", "Time", "Likely Source");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    const spike_class_t classes[] = {
+        {"short",  0.0,    2000.0,  50000.0},
+        {"medium", 2000.0, 50000.0, 20000000.0},
+        {"long",   50000.0, 1e300,  total / 2}
+    };
+    for (int c = 0; c < 3; c++) {
+        size_t count = 0;
+        double excess_sum = 0.0;
+        for (size_t i = 0; i < samples; i++) {
+            double excess = delta[i] - median;
+            if (delta[i] <= threshold || excess < classes[c].min_excess_ns || excess >= classes[c].max_excess_ns) {
+                continue;
+            }
+            times[count] = (double)(trace[i] - trace[0]) / ticks_per_ns;
+            sorted[count] = excess;
+            excess_sum += excess;
+            count++;
+        }
+        if (count == 0) {
+            printf("%-10s %8d %12s %9s %12s %8s  %s\n", classes[c].name, 0, "-", "-", "-", "-", "-");
+            continue;
+        }
+        qsort(sorted, count, sizeof(double), compare_double);
+        double period_ns = 0.0;
+        double strength = find_event_period(times, count, classes[c].window_ns, &period_ns);
+        char period_str[32];
+        const char* source;
+        if (strength >= 0.3) {
+            if (period_ns >= 1e6) snprintf(period_str, sizeof(period_str), "%.2f ms", period_ns / 1e6);
+            else snprintf(period_str, sizeof(period_str), "%.2f us", period_ns / 1e3);
+            source = periodic_source_hint(period_ns);
+        } else {
+            snprintf(period_str, sizeof(period_str), "aperiodic");
+            source = c == 2 ? "SMI or preemption" : "-";
+        }
+        printf("%-10s %8zu %12s %8.0f%% %9.2f us %7.3f%%  %s\n", classes[c].name, count, period_str,
+               100.0 * strength, sorted[count / 2] / 1000.0, 100.0 * excess_sum / total, source);
+    }
+    
+    free(delta);
+    free(sorted);
+    free(times);
+}
+
+void run_trace_case(size_t size, const char* label, double ticks_per_ns) {
+    void* chain = aligned_malloc(64, size);
+    uint64_t* trace = malloc((TRACE_SAMPLES + 1) * sizeof(uint64_t));
+    if (!chain || !trace || !build_pointer_chain(chain, size)) {
+        fprintf(stderr, "Failed to set up %s latency trace\n", label);
+        free(chain);
+        free(trace);
+        return;
+    }
+    
+    // Size samples so each covers about TRACE_SAMPLE_NS
+    double hop_ns = chase_pointer_chain(chain, LATENCY_ACCESSES / 10) * 1e9 / (LATENCY_ACCESSES / 10);
+    size_t hops = (size_t)(TRACE_SAMPLE_NS / (hop_ns > 0.1 ? hop_ns : 0.1));
+    if (hops < 1) hops = 1;
+    
+    printf("\n%s (%zu KB chain):\n", label, size / 1024);
+    record_latency_trace(chain, hops, trace, TRACE_SAMPLES);
+    snprintf(record_case, sizeof(record_case), "%s", label);
+    analyze_latency_trace(trace, TRACE_SAMPLES, hops, ticks_per_ns);
+    record_case[0] = '\0';
+    free(chain);
+    free(trace);
+}
+
+void run_trace_tests(size_t dram_size) {
+    size_t l1 = find_cache_size(1, KB_TO_BYTES(32));
+    size_t llc = find_cache_size(3, find_cache_size(2, KB_TO_BYTES(256)));
+    if (dram_size < llc * 2) dram_size = llc * 2;
+#ifdef HAVE_X86_INTRINSICS
+    double ticks_per_ns = calibrate_tsc();
+#else
+    double ticks_per_ns = 1.0;
+#endif
+    
+    printf("\nRunning time-domain latency trace...\n");
+    // The L1 trace shows interrupts and SMIs on their own; DRAM adds refresh
+    run_trace_case(l1 / 2, "L1-resident trace", ticks_per_ns);
+    run_trace_case(dram_size, "DRAM trace", ticks_per_ns);
+}
+
+// ---------------------------------------------------------------------------
+// NUMA memory policies: bind, interleave and weighted interleave per node set
+// ---------------------------------------------------------------------------
+
+#define MPOL_DEFAULT 0
+#define MPOL_BIND 2
+#define MPOL_INTERLEAVE 3
+#define MPOL_WEIGHTED_INTERLEAVE 6              // Linux 6.9+
+#define MPOL_MF_MOVE (1 << 1)
+
+long sys_mbind(void* addr, size_t len, int mode, const unsigned long* mask, unsigned long maxnode, unsigned flags) {
+    return syscall(SYS_mbind, addr, len, mode, mask, maxnode, flags);
+}
+
+long sys_move_pages(size_t count, void** pages, const int* nodes, int* status, int flags) {
+    return syscall(SYS_move_pages, 0, count, pages, nodes, status, flags);
+}
+
+// NUMA node of the calling CPU, or 0 if unknown
+int current_numa_node(void) {
+    unsigned int cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) return 0;
+    return (int)node;
+}
+
+// Nodes with memory (CPU-less tiers included); returns the count, at least node 0
+int read_memory_nodes(int* nodes, int max_nodes) {
+    int count = read_cpu_list_file("/sys/devices/system/node/has_memory", nodes, max_nodes);
+    if (count == 0) {
+        nodes[0] = 0;
+        count = 1;
+    }
+    return count;
+}
+
+int numa_node_has_cpus(int node) {
+    static int nodes[NUMA_MAX_NODES];
+    int count = read_cpu_list_file("/sys/devices/system/node/has_cpu", nodes, NUMA_MAX_NODES);
+    return count == 0 ? node == 0 : cpu_in_list(node, nodes, count);
+}
+
+// Read a small integer from a sysfs/procfs file, or `fallback`
+long read_sysfs_long(const char* path, long fallback) {
+    char buffer[64];
+    FILE* fp = fopen(path, "r");
+    if (!fp) return fallback;
+    long value = fallback;
+    if (fgets(buffer, sizeof(buffer), fp)) value = strtol(buffer, NULL, 10);
+    fclose(fp);
+    return value;
+}
+
+// SLIT distance between two nodes, or -1 if unknown
+int numa_distance(int from, int to) {
+    char path[128];
+    char buffer[1024];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/distance", from);
+    FILE* fp = fopen(path, "r");
+    if (!fp) return -1;
+    int distance = -1;
+    if (fgets(buffer, sizeof(buffer), fp)) {
+        char* p = buffer;
+        for (int i = 0; i <= to; i++) {
+            char* end;
+            long value = strtol(p, &end, 10);
+            if (end == p) {
+                value = -1;
+                i = to;
+            }
+            distance = (int)value;
+            p = end;
+        }
+    }
+    fclose(fp);
+    return distance;
+}
+
+// Map `size` bytes with `mode` over `mask` and fault it in, so the pages land
+// where the policy says. Returns NULL (errno from mbind) on failure.
+void* numa_alloc_policy(size_t size, int mode, unsigned long mask) {
+    void* p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return NULL;
+    if (sys_mbind(p, size, mode, mode == MPOL_DEFAULT ? NULL : &mask, NUMA_MAX_NODES + 1, 0) != 0) {
+        int saved = errno;
+        munmap(p, size);
+        errno = saved;
+        return NULL;
+    }
+    memset(p, 0xAA, size);
+    return p;
+}
+
+// Count where a sample of the buffer's pages live; counts[] has NUMA_MAX_NODES
+// entries. Returns the number of pages sampled, 0 if move_pages is unavailable.
+int numa_page_nodes(void* buffer, size_t size, int* counts) {
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t pages = size / page_size;
+    size_t step = pages > NUMA_SAMPLE_PAGES ? pages / NUMA_SAMPLE_PAGES : 1;
+    void* addrs[NUMA_SAMPLE_PAGES];
+    int status[NUMA_SAMPLE_PAGES];
+    int count = 0;
+    for (size_t i = 0; i < pages && count < NUMA_SAMPLE_PAGES; i += step) {
+        addrs[count++] = (char*)buffer + i * page_size;
+    }
+    memset(counts, 0, NUMA_MAX_NODES * sizeof(int));
+    if (sys_move_pages(count, addrs, NULL, status, 0) != 0) return 0;
+    int sampled = 0;
+    for (int i = 0; i < count; i++) {
+        if (status[i] >= 0 && status[i] < NUMA_MAX_NODES) {
+            counts[status[i]]++;
+            sampled++;
+        }
+    }
+    return sampled;
+}
+
+// "0:50% 1:50%" style placement summary
+void format_page_nodes(void* buffer, size_t size, char* out, size_t out_size) {
+    int counts[NUMA_MAX_NODES];
+    int sampled = numa_page_nodes(buffer, size, counts);
+    out[0] = '\0';
+    if (sampled == 0) {
+        snprintf(out, out_size, "unknown");
+        return;
+    }
+    size_t len = 0;
+    for (int n = 0; n < NUMA_MAX_NODES && len < out_size; n++) {
+        if (counts[n] == 0) continue;
+        len += snprintf(out + len, out_size - len, "%s%d:%.0f%%", len ? " " : "", n, 100.0 * counts[n] / sampled);
+    }
+}
+
+void format_node_mask(unsigned long mask, char* out, size_t out_size) {
+    size_t len = 0;
+    snprintf(out, out_size, "%s", mask ? "" : "local");
+    for (int n = 0; n < NUMA_MAX_NODES && len < out_size; n++) {
+        if (mask & (1UL << n)) len += snprintf(out + len, out_size - len, "%s%d", len ? "," : "", n);
+    }
+}
+
+void run_numa_policy_case(const char* name, int mode, unsigned long mask, size_t size, int num_threads) {
+    char nodes_str[64];
+    char placement[128];
+    format_node_mask(mask, nodes_str, sizeof(nodes_str));
+    
+    void* buffer = numa_alloc_policy(size, mode, mask);
+    if (!buffer) {
+        printf("%-22s %-10s %s\n", name, nodes_str,
+               errno == EINVAL && mode == MPOL_WEIGHTED_INTERLEAVE ? "unsupported by this kernel" : strerror(errno));
+        return;
+    }
+    double read_time = test_threaded_sequential_read(buffer, size, ITERATIONS, num_threads);
+    double latency_time = test_memory_latency(buffer, size, LATENCY_ACCESSES);
+    format_page_nodes(buffer, size, placement, sizeof(placement));
+    munmap(buffer, size);
+    
+    double gbps = read_time > 0 ? (double)size * ITERATIONS / (1024.0 * 1024.0 * 1024.0) / read_time : 0.0;
+    double latency_ns = latency_time > 0 ? latency_time * 1e9 / LATENCY_ACCESSES : 0.0;
+    char label[sizeof(nodes_str) + 32];
+    snprintf(label, sizeof(label), "%s [%s]", name, nodes_str);
+    record_bandwidth(label, gbps);
+    printf("%-22s %-10s %8.3f GB/s %8.1f ns  %s\n", name, nodes_str, gbps, latency_ns, placement);
+}
+
+void run_numa_tests(size_t size, int num_threads) {
+    int nodes[NUMA_MAX_NODES];
+    int num_nodes = read_memory_nodes(nodes, NUMA_MAX_NODES);
+    int local = current_numa_node();
+    size_t llc = find_cache_size(3, find_cache_size(2, KB_TO_BYTES(256)));
+    if (size < llc * 2) size = llc * 2;
+    
+    printf("\nRunning NUMA memory policy tests (%zu MB buffers, %d threads, running on node %d)...\n",
+           size / (1024 * 1024), num_threads, local);
+    printf("%-6s %-10s %12s %10s %8s\n", "Node", "CPUs", "Memory", "Distance", "Weight");
+    printf("--------------------------------------------------------------------------------\n");
+    unsigned long all_mask = 0, cpu_mask = 0;
+    for (int i = 0; i < num_nodes; i++) {
+        char path[128];
+        int node = nodes[i];
+        if (node >= NUMA_MAX_NODES) continue;
+        all_mask |= 1UL << node;
+        if (numa_node_has_cpus(node)) cpu_mask |= 1UL << node;
+        
+        long mem_kb = 0;
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/meminfo", node);
+        FILE* fp = fopen(path, "r");
+        if (fp) {
+            char line[256];
+            while (fgets(line, sizeof(line), fp)) {
+                char* total = strstr(line, "MemTotal:");
+                if (total) mem_kb = strtol(total + 9, NULL, 10);
+            }
+            fclose(fp);
+        }
+        snprintf(path, sizeof(path), "/sys/kernel/mm/mempolicy/weighted_interleave/node%d", node);
+        printf("%-6d %-10s %9ld MB %10d %8ld\n", node, numa_node_has_cpus(node) ? "yes" : "none (tier)",
+               mem_kb / 1024, numa_distance(local, node), read_sysfs_long(path, -1));
+    }
+    if (num_nodes == 1) {
+        printf("Single memory node: running in degenerate mode, every policy resolves to node %d\n", nodes[0]);
+    }
+    
+    printf("\n%-22s %-10s %13s %11s  %s\n", "Policy", "Nodes", "Read BW", "Latency", "Placement (sampled pages)");
+    printf("--------------------------------------------------------------------------------\n");
+    run_numa_policy_case("default (first touch)", MPOL_DEFAULT, 0, size, num_threads);
+    for (int i = 0; i < num_nodes; i++) {
+        if (nodes[i] >= NUMA_MAX_NODES) continue;
+        run_numa_policy_case(numa_node_has_cpus(nodes[i]) ? "bind" : "bind (CPU-less)",
+                             MPOL_BIND, 1UL << nodes[i], size, num_threads);
+    }
+    run_numa_policy_case("interleave", MPOL_INTERLEAVE, all_mask, size, num_threads);
+    run_numa_policy_case("weighted interleave", MPOL_WEIGHTED_INTERLEAVE, all_mask, size, num_threads);
+    if (cpu_mask && cpu_mask != all_mask) {
+        // Tiered systems: also interleave across the CPU-attached nodes alone
+        run_numa_policy_case("interleave (CPU nodes)", MPOL_INTERLEAVE, cpu_mask, size, num_threads);
+        run_numa_policy_case("weighted (CPU nodes)", MPOL_WEIGHTED_INTERLEAVE, cpu_mask, size, num_threads);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Page migration cost: move_pages and mbind(MPOL_MF_MOVE) between nodes
+// ---------------------------------------------------------------------------
+
+typedef enum { MIGRATE_MOVE_PAGES, MIGRATE_MBIND } migrate_method_t;
+
+typedef struct {
+    char* buffer;               // Pointer chain being migrated
+    size_t size;
+    size_t page_size;           // Granularity of the move_pages address list
+    migrate_method_t method;
+    int dst;
+    volatile int stop;
+    double migrate_time;
+    double chase_ns;            // Chase latency while the migration ran
+    int error;                  // errno of a failed migration call, 0 on success
+} migrate_args_t;
+
+// Thread 0 migrates the buffer to args->dst; thread 1 keeps chasing it until done
+void migrate_worker(thread_ctx_t* ctx) {
+    migrate_args_t* args = (migrate_args_t*)ctx->shared;
+    
+    if (ctx->thread_id == 0) {
+        size_t count = args->size / args->page_size;
+        void** pages = malloc(count * sizeof(void*));
+        int* nodes = malloc(count * sizeof(int));
+        int* status = malloc(count * sizeof(int));
+        for (size_t i = 0; pages && nodes && i < count; i++) {
+            pages[i] = args->buffer + i * args->page_size;
+            nodes[i] = args->dst;
+        }
+        unsigned long mask = 1UL << args->dst;
+        
+        thread_timed_begin(ctx);
+        double start_time = get_time();
+        long rc;
+        if (args->method == MIGRATE_MOVE_PAGES) {
+            rc = pages && nodes && status ? sys_move_pages(count, pages, nodes, status, MPOL_MF_MOVE) : -1;
+        } else {
+            rc = sys_mbind(args->buffer, args->size, MPOL_BIND, &mask, NUMA_MAX_NODES + 1, MPOL_MF_MOVE);
+        }
+        args->migrate_time = get_time() - start_time;
+        args->error = rc < 0 ? errno : 0;
+        args->stop = 1;
+        thread_timed_end(ctx);
+        free(pages);
+        free(nodes);
+        free(status);
+    } else {
+        char* data = args->buffer;
+        volatile char* ptr = data;
+        size_t hops = 0;
+        thread_timed_begin(ctx);
+        double start_time = get_time();
+        while (!args->stop) {
+            for (int i = 0; i < 1024; i++) {
+                ptr = data + *((volatile size_t*)ptr);
+            }
+            hops += 1024;
+        }
+        double elapsed = get_time() - start_time;
+        thread_timed_end(ctx);
+        args->chase_ns = hops ? elapsed * 1e9 / hops : 0.0;
+        ctx->sink = (uintptr_t)ptr;
+    }
+}
+
+// AnonHugePages of the mapping that contains `p`, from /proc/self/smaps, or -1 if unknown
+long long mapping_anon_huge_bytes(const void* p) {
+    char line[256];
+    FILE* fp = fopen("/proc/self/smaps", "r");
+    if (!fp) return -1;
+    long long bytes = -1;
+    int inside = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        unsigned long start, end;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {  // Mapping header line
+            if (inside) break;
+            inside = (uintptr_t)p >= start && (uintptr_t)p < end;
+        } else if (inside && strncmp(line, "AnonHugePages:", 14) == 0) {
+            bytes = strtoll(line + 14, NULL, 10) * 1024;
+        }
+    }
+    fclose(fp);
+    return bytes;
+}
+
+// Allocate the buffer on `src` with the requested page size and link it into
+// a chain. 2 MB buffers are mapped 2 MB aligned so THPs can back all of it.
+// Returns NULL with *error set to the failing step.
+char* alloc_migration_buffer(size_t size, size_t page_size, int src, const char** error) {
+    int huge = page_size >= HUGEPAGE_SIZE;
+    size_t map_size = huge ? size + HUGEPAGE_SIZE : size;
+    char* map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+        *error = "mmap";
+        return NULL;
+    }
+    char* buffer = map;
+    if (huge) {
+        buffer = (char*)(((uintptr_t)map + HUGEPAGE_SIZE - 1) & ~(uintptr_t)(HUGEPAGE_SIZE - 1));
+        if (buffer > map) munmap(map, buffer - map);
+        if (map + map_size > buffer + size) munmap(buffer + size, map + map_size - (buffer + size));
+    }
+    madvise(buffer, size, huge ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+    unsigned long mask = 1UL << src;
+    if (sys_mbind(buffer, size, MPOL_BIND, &mask, NUMA_MAX_NODES + 1, 0) != 0) {
+        *error = "mbind";
+        munmap(buffer, size);
+        return NULL;
+    }
+    if (!build_pointer_chain(buffer, size)) {
+        *error = "pointer chain";
+        munmap(buffer, size);
+        return NULL;
+    }
+    return buffer;
+}
+
+void run_migration_case(migrate_method_t method, size_t size, size_t page_size, int src, int dst) {
+    const char* method_name = method == MIGRATE_MOVE_PAGES ? "move_pages" : "mbind+MF_MOVE";
+    char page_str[32];
+    snprintf(page_str, sizeof(page_str), page_size >= HUGEPAGE_SIZE ? "%zu MB" : "%zu KB",
+             page_size >= HUGEPAGE_SIZE ? page_size / (1024 * 1024) : page_size / 1024);
+    
+    migrate_args_t args = {0};
+    const char* error = "";
+    args.buffer = alloc_migration_buffer(size, page_size, src, &error);
+    if (!args.buffer) {
+        printf("%-14s %-6s failed to allocate %zu MB on node %d (%s: %s)\n", method_name, page_str,
+               size / (1024 * 1024), src, error, strerror(errno));
+        return;
+    }
+    if (page_size >= HUGEPAGE_SIZE) {
+        // Without THPs the address list would name one 4 KB page per 2 MB
+        long long huge_bytes = mapping_anon_huge_bytes(args.buffer);
+        if (huge_bytes < (long long)size) {
+            if (huge_bytes < 0) {
+                printf("%-14s %-6s skipped: THP backing unknown (no /proc/self/smaps)\n", method_name, page_str);
+            } else {
+                printf("%-14s %-6s skipped: only %.0f%% THP-backed\n", method_name, page_str,
+                       100.0 * huge_bytes / size);
+            }
+            munmap(args.buffer, size);
+            return;
+        }
+    }
+    args.size = size;
+    args.page_size = page_size;
+    args.method = method;
+    args.dst = dst;
+    double baseline_ns = chase_pointer_chain(args.buffer, LATENCY_ACCESSES / 4) * 1e9 / (LATENCY_ACCESSES / 4);
+    
+    if (run_threaded(2, migrate_worker, &args, NULL) < 0) {
+        munmap(args.buffer, size);
+        return;
+    }
+    int counts[NUMA_MAX_NODES];
+    int sampled = numa_page_nodes(args.buffer, size, counts);
+    munmap(args.buffer, size);
+    if (args.error) {
+        printf("%-14s %-6s failed: %s\n", method_name, page_str, strerror(args.error));
+        return;
+    }
+    
+    double pages = (double)size / page_size;
+    snprintf(record_case, sizeof(record_case), "%s", page_str);
+    record_bandwidth(method_name, (double)size / (1024.0 * 1024.0 * 1024.0) / args.migrate_time);
+    record_case[0] = '\0';
+    printf("%-14s %-6s %8.0f %8.2f ms %10.0f %8.3f GB/s %5.0f%% %7.1f ns (%5.1f)\n",
+           method_name, page_str, pages, args.migrate_time * 1e3, pages / args.migrate_time,
+           (double)size / (1024.0 * 1024.0 * 1024.0) / args.migrate_time,
+           sampled ? 100.0 * counts[dst] / sampled : 0.0, args.chase_ns, baseline_ns);
+}
+
+void run_migration_tests(size_t size) {
+    int nodes[NUMA_MAX_NODES];
+    int num_nodes = read_memory_nodes(nodes, NUMA_MAX_NODES);
+    int src = current_numa_node();
+    int dst = src;
+    for (int i = 0; i < num_nodes && dst == src; i++) {
+        if (nodes[i] != src && nodes[i] < NUMA_MAX_NODES) dst = nodes[i];
+    }
+    size = (size + HUGEPAGE_SIZE - 1) / HUGEPAGE_SIZE * HUGEPAGE_SIZE;
+    
+    printf("\nRunning page migration tests (%zu MB buffer, node %d -> node %d)...\n",
+           size / (1024 * 1024), src, dst);
+    if (dst == src) {
+        printf("Single memory node: pages are already on the target, so this measures the no-op cost\n");
+    }
+    if (sysconf(_SC_NPROCESSORS_ONLN) < 2) {
+        printf("Warning: only one CPU available; the chase time-shares with the migrating thread\n");
+    }
+    printf("%-14s %-6s %8s %11s %10s %13s %6s %s\n", "Method", "Page", "Pages", "Time", "Pages/s",
+           "Bandwidth", "Moved", "Chase during (idle)");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    const size_t page_sizes[] = {(size_t)sysconf(_SC_PAGESIZE), HUGEPAGE_SIZE};
+    for (int p = 0; p < 2; p++) {
+        run_migration_case(MIGRATE_MOVE_PAGES, size, page_sizes[p], src, dst);
+        run_migration_case(MIGRATE_MBIND, size, page_sizes[p], src, dst);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// AutoNUMA: convergence of remotely placed memory under kernel balancing
+// ---------------------------------------------------------------------------
+
+// Counter from /proc/vmstat, or -1 if the kernel does not export it
+long read_vmstat(const char* name) {
+    char line[256];
+    size_t len = strlen(name);
+    FILE* fp = fopen("/proc/vmstat", "r");
+    if (!fp) return -1;
+    long value = -1;
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, name, len) == 0 && line[len] == ' ') {
+            value = strtol(line + len + 1, NULL, 10);
+            break;
+        }
+    }
+    fclose(fp);
+    return value;
+}
+
+typedef struct {
+    long hint_faults;
+    long hint_faults_local;
+    long pages_migrated;
+    long pte_updates;
+} numa_counters_t;
+
+void read_numa_counters(numa_counters_t* c) {
+    c->hint_faults = read_vmstat("numa_hint_faults");
+    c->hint_faults_local = read_vmstat("numa_hint_faults_local");
+    c->pages_migrated = read_vmstat("numa_pages_migrated");
+    c->pte_updates = read_vmstat("numa_pte_updates");
+}
+
+// Restrict the calling thread (and threads it creates) to the CPUs of `node`
+int pin_to_numa_node(int node) {
+    static int cpus[MAX_CPUS];
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    int count = read_cpu_list_file(path, cpus, MAX_CPUS);
+    if (count == 0) return 0;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int i = 0; i < count; i++) CPU_SET(cpus[i], &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+void run_autonuma_tests(size_t size, int num_threads) {
+    int nodes[NUMA_MAX_NODES];
+    int num_nodes = read_memory_nodes(nodes, NUMA_MAX_NODES);
+    int local = current_numa_node();
+    int remote = local;
+    for (int i = 0; i < num_nodes && remote == local; i++) {
+        if (nodes[i] != local && nodes[i] < NUMA_MAX_NODES) remote = nodes[i];
+    }
+    size_t llc = find_cache_size(3, find_cache_size(2, KB_TO_BYTES(256)));
+    if (size < llc * 2) size = llc * 2;
+    long mode = read_sysfs_long("/proc/sys/kernel/numa_balancing", -1);
+    
+    printf("\nRunning AutoNUMA balancing tests (%zu MB on node %d, %d threads on node %d, %d s)...\n",
+           size / (1024 * 1024), remote, num_threads, local, AUTONUMA_SECONDS);
+    printf("kernel.numa_balancing = %ld (%s)\n", mode,
+           mode < 0 ? "not available" : mode == 0 ? "disabled" : (mode & 1) ? "enabled" : "memory tiering only");
+    if (remote == local) {
+        printf("Single memory node: nothing to migrate, measuring hinting-fault noise only\n");
+    }
+    
+    cpu_set_t saved_affinity;
+    pthread_getaffinity_np(pthread_self(), sizeof(saved_affinity), &saved_affinity);
+    pin_to_numa_node(local);
+    
+    // Bind to place the pages remotely, then drop back to the default policy so balancing may move them
+    unsigned long mask = 1UL << remote;
+    char* buffer = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED || sys_mbind(buffer, size, MPOL_BIND, &mask, NUMA_MAX_NODES + 1, 0) != 0 ||
+        !build_pointer_chain(buffer, size) || sys_mbind(buffer, size, MPOL_DEFAULT, NULL, 0, 0) != 0) {
+        fprintf(stderr, "Failed to place AutoNUMA test buffer on node %d\n", remote);
+        if (buffer != MAP_FAILED) munmap(buffer, size);
+        pthread_setaffinity_np(pthread_self(), sizeof(saved_affinity), &saved_affinity);
+        return;
+    }
+    
+    numa_counters_t start, now;
+    read_numa_counters(&start);
+    printf("%8s %12s %12s %8s %12s %12s\n", "Time", "Read BW", "Latency", "Local", "Hint Faults", "Migrated");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    double bw[AUTONUMA_MAX_ROUNDS], when[AUTONUMA_MAX_ROUNDS], span[AUTONUMA_MAX_ROUNDS];
+    int rounds = 0;
+    double converged = -1.0;
+    double begin = get_time(), last_print = -1.0;
+    while (rounds < AUTONUMA_MAX_ROUNDS && get_time() - begin < AUTONUMA_SECONDS) {
+        double round_start = get_time();
+        double read_time = test_threaded_sequential_read(buffer, size, 1, num_threads);
+        double latency_ns = chase_pointer_chain(buffer, LATENCY_ACCESSES / 4) * 1e9 / (LATENCY_ACCESSES / 4);
+        double t = get_time() - begin;
+        
+        int counts[NUMA_MAX_NODES];
+        int sampled = numa_page_nodes(buffer, size, counts);
+        double local_share = sampled ? (double)counts[local] / sampled : 0.0;
+        if (converged < 0 && local_share >= AUTONUMA_CONVERGED) converged = t;
+        
+        bw[rounds] = read_time > 0 ? (double)size / (1024.0 * 1024.0 * 1024.0) / read_time : 0.0;
+        when[rounds] = t;
+        span[rounds] = get_time() - round_start;
+        trace_counter("AutoNUMA read", bw[rounds]);
+        rounds++;
+        if (t - last_print >= 1.0 || last_print < 0) {
+            read_numa_counters(&now);
+            printf("%6.1f s %7.3f GB/s %9.1f ns %7.0f%% %12ld %12ld\n", t, bw[rounds - 1], latency_ns,
+                   100.0 * local_share, now.hint_faults - start.hint_faults, now.pages_migrated - start.pages_migrated);
+            last_print = t;
+        }
+    }
+    read_numa_counters(&now);
+    munmap(buffer, size);
+    pthread_setaffinity_np(pthread_self(), sizeof(saved_affinity), &saved_affinity);
+    
+    // Compare each round with the last quarter's bandwidth to estimate what convergence cost
+    double steady = 0.0;
+    int steady_rounds = 0;
+    for (int i = rounds - (rounds / 4 > 0 ? rounds / 4 : 1); i < rounds; i++) {
+        steady += bw[i];
+        steady_rounds++;
+    }
+    steady = steady_rounds ? steady / steady_rounds : 0.0;
+    double lost = 0.0;
+    for (int i = 0; i < rounds && steady > 0; i++) {
+        if (converged >= 0 && when[i] > converged) break;
+        if (bw[i] < steady) lost += span[i] * (1.0 - bw[i] / steady);
+    }
+    
+    if (rounds > 0) {
+        record_bandwidth("First round read", bw[0]);
+        record_bandwidth("Steady read", steady);
+    }
+    
+    printf("--------------------------------------------------------------------------------\n");
+    if (now.hint_faults < 0) {
+        printf("Hinting-fault counters not in /proc/vmstat (kernel built without NUMA balancing)\n");
+    } else {
+        long faults = now.hint_faults - start.hint_faults;
+        printf("%-34s %ld (%ld local), %.0f/s\n", "NUMA hinting faults:", faults,
+               now.hint_faults_local - start.hint_faults_local, faults / (when[rounds - 1] > 0 ? when[rounds - 1] : 1));
+        printf("%-34s %ld pages, %ld PTE updates\n", "Pages migrated:", now.pages_migrated - start.pages_migrated,
+               now.pte_updates - start.pte_updates);
+    }
+    if (converged >= 0) {
+        printf("%-34s %.1f s (%.0f%% of sampled pages local)\n", "Convergence time:", converged, 100.0 * AUTONUMA_CONVERGED);
+        printf("%-34s %.2f s of bandwidth below steady state (%.3f GB/s)\n", "Convergence overhead:", lost, steady);
+    } else {
+        printf("%-34s not converged within %d s\n", "Convergence time:", AUTONUMA_SECONDS);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Fragmentation aging: allocation churn, then RSS and traversal of live objects
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    void** objects;
+    size_t* sizes;
+    size_t count;
+    size_t live_bytes;
+} aging_heap_t;
+
+typedef struct {
+    size_t rss_bytes;
+    size_t anon_huge_bytes;
+    double free_mb;              // System free memory in the buddy allocator
+    double high_order_share;     // Share of it in blocks of 2 MB or larger
+} memory_snapshot_t;
+
+// Object size drawn log-uniformly between AGING_MIN_OBJECT and AGING_MAX_OBJECT
+size_t aging_object_size(uint64_t* rng) {
+    double span = log((double)AGING_MAX_OBJECT / AGING_MIN_OBJECT);
+    size_t size = (size_t)(AGING_MIN_OBJECT * exp(xorshift64_unit(rng) * span));
+    return size < sizeof(void*) ? sizeof(void*) : size;
+}
+
+void take_memory_snapshot(memory_snapshot_t* snap) {
+    char line[512];
+    long page_size = sysconf(_SC_PAGESIZE);
+    memset(snap, 0, sizeof(*snap));
+    
+    FILE* fp = fopen("/proc/self/statm", "r");
+    if (fp) {
+        unsigned long size_pages, resident_pages;
+        if (fscanf(fp, "%lu %lu", &size_pages, &resident_pages) == 2) {
+            snap->rss_bytes = resident_pages * page_size;
+        }
+        fclose(fp);
+    }
+    fp = fopen("/proc/self/smaps_rollup", "r");
+    if (fp) {
+        while (fgets(line, sizeof(line), fp)) {
+            if (strncmp(line, "AnonHugePages:", 14) == 0) snap->anon_huge_bytes = strtoul(line + 14, NULL, 10) * 1024;
+        }
+        fclose(fp);
+    }
+    
+    // buddyinfo: "Node 0, zone Normal c0 c1 ... c10", free block counts per order
+    fp = fopen("/proc/buddyinfo", "r");
+    if (fp) {
+        double total_pages = 0.0, high_pages = 0.0;
+        int huge_order = 0;
+        while (((size_t)page_size << huge_order) < HUGEPAGE_SIZE) huge_order++;
+        while (fgets(line, sizeof(line), fp)) {
+            char* p = strstr(line, "zone");
+            if (!p) continue;
+            p += 4;
+            while (*p == ' ') p++;
+            while (*p && *p != ' ') p++;  // Zone name
+            for (int order = 0;; order++) {
+                char* end;
+                long count = strtol(p, &end, 10);
+                if (end == p) break;
+                double pages = (double)count * (1L << order);
+                total_pages += pages;
+                if (order >= huge_order) high_pages += pages;
+                p = end;
+            }
+        }
+        fclose(fp);
+        snap->free_mb = total_pages * page_size / (1024.0 * 1024.0);
+        snap->high_order_share = total_pages > 0 ? high_pages / total_pages : 0.0;
+    }
+}
+
+// Fill the heap with objects of random sizes until it holds `target` bytes
+int aging_heap_fill(aging_heap_t* heap, size_t target, uint64_t* rng) {
+    size_t capacity = target / AGING_MIN_OBJECT + 1;
+    heap->objects = calloc(capacity, sizeof(void*));
+    heap->sizes = calloc(capacity, sizeof(size_t));
+    heap->count = 0;
+    heap->live_bytes = 0;
+    if (!heap->objects || !heap->sizes) return 0;
+    while (heap->live_bytes < target && heap->count < capacity) {
+        size_t size = aging_object_size(rng);
+        void* p = malloc(size);
+        if (!p) return 0;
+        memset(p, (int)(heap->count & 0xFF), size);
+        heap->objects[heap->count] = p;
+        heap->sizes[heap->count] = size;
+        heap->live_bytes += size;
+        heap->count++;
+    }
+    return 1;
+}
+
+void aging_heap_free(aging_heap_t* heap) {
+    for (size_t i = 0; i < heap->count; i++) free(heap->objects[i]);
+    free(heap->objects);
+    free(heap->sizes);
+    memset(heap, 0, sizeof(*heap));
+}
+
+// Replace random live objects with new ones of random size for `seconds`.
+// Every AGING_BURST_INTERVAL replacements a burst of short-lived objects is
+// allocated and freed, like per-request garbage. Returns replacements done.
+size_t aging_churn(aging_heap_t* heap, double seconds, uint64_t* rng) {
+    void* burst[AGING_BURST_OBJECTS];
+    size_t ops = 0;
+    double end_time = get_time() + seconds;
+    while (get_time() < end_time) {
+        for (int k = 0; k < 1024; k++, ops++) {
+            size_t slot = xorshift64(rng) % heap->count;
+            size_t size = aging_object_size(rng);
+            void* p = malloc(size);
+            if (!p) return ops;
+            memset(p, (int)(ops & 0xFF), size);
+            heap->live_bytes += size - heap->sizes[slot];
+            free(heap->objects[slot]);
+            heap->objects[slot] = p;
+            heap->sizes[slot] = size;
+            
+            if (ops % AGING_BURST_INTERVAL == 0) {
+                for (int b = 0; b < AGING_BURST_OBJECTS; b++) {
+                    burst[b] = malloc(aging_object_size(rng));
+                    if (burst[b]) *(volatile char*)burst[b] = 1;
+                }
+                for (int b = 0; b < AGING_BURST_OBJECTS; b++) free(burst[b]);
+            }
+        }
+    }
+    return ops;
+}
+
+// Read every live object in slot order; returns GB/s over the whole words
+// read, so tail bytes past the last word are not counted
+double aging_traverse(const aging_heap_t* heap) {
+    volatile uint64_t sum = 0;
+    size_t read_bytes = 0;
+    for (size_t i = 0; i < heap->count; i++) read_bytes += heap->sizes[i] / sizeof(uint64_t) * sizeof(uint64_t);
+    double start_time = get_time();
+    for (int iter = 0; iter < ITERATIONS; iter++) {
+        for (size_t i = 0; i < heap->count; i++) {
+            const uint64_t* data = (const uint64_t*)heap->objects[i];
+            size_t words = heap->sizes[i] / sizeof(uint64_t);
+            uint64_t local = 0;
+            for (size_t w = 0; w < words; w++) local += data[w];
+            sum += local;
+        }
+    }
+    double elapsed = get_time() - start_time;
+    return (double)read_bytes * ITERATIONS / (1024.0 * 1024.0 * 1024.0) / elapsed;
+}
+
+// Link the live objects in random order through their first word and chase
+// them; returns ns per hop
+double aging_chase(aging_heap_t* heap, uint64_t* rng) {
+    size_t* order = malloc(heap->count * sizeof(size_t));
+    if (!order) return -1.0;
+    for (size_t i = 0; i < heap->count; i++) order[i] = i;
+    for (size_t i = heap->count - 1; i > 0; i--) {
+        size_t j = xorshift64(rng) % (i + 1);
+        size_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    for (size_t i = 0; i < heap->count; i++) {
+        *(void**)heap->objects[order[i]] = heap->objects[order[(i + 1) % heap->count]];
+    }
+    void* volatile p = heap->objects[order[0]];
+    free(order);
+    
+    double start_time = get_time();
+    for (size_t i = 0; i < LATENCY_ACCESSES; i++) {
+        p = *(void**)p;
+    }
+    double elapsed = get_time() - start_time;
+    return elapsed * 1e9 / LATENCY_ACCESSES;
+}
+
+void print_aging_row(const char* label, const aging_heap_t* heap, const memory_snapshot_t* snap,
+                     size_t rss_base, double gbps, double chase_ns) {
+    double rss = snap->rss_bytes > rss_base ? (double)(snap->rss_bytes - rss_base) : 0.0;
+    printf("%-8s %8.1f MB %8.1f MB %6.2fx %7.0f MB %6.1f%% %8.3f GB/s %7.1f ns\n", label,
+           heap->live_bytes / (1024.0 * 1024.0), rss / (1024.0 * 1024.0),
+           heap->live_bytes ? rss / heap->live_bytes : 0.0,
+           snap->anon_huge_bytes / (1024.0 * 1024.0), 100.0 * snap->high_order_share, gbps, chase_ns);
+}
+
+void run_aging_tests(size_t live_target, int seconds) {
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    aging_heap_t heap;
+    memory_snapshot_t base, fresh, aged, freed;
+    
+    printf("\nRunning fragmentation aging tests (%zu MB live, objects %d B-%d KB, %d s churn)...\n",
+           live_target / (1024 * 1024), AGING_MIN_OBJECT, AGING_MAX_OBJECT / 1024, seconds);
+    malloc_trim(0);  // Drop free memory left by earlier tests so the RSS baseline is clean
+    take_memory_snapshot(&base);
+    if (!aging_heap_fill(&heap, live_target, &rng)) {
+        fprintf(stderr, "Failed to allocate the aging heap\n");
+        aging_heap_free(&heap);
+        return;
+    }
+    printf("%-8s %11s %11s %7s %10s %7s %13s %10s\n", "State", "Live", "RSS", "RSS/Live", "Anon THP",
+           "Free>=2M", "Traversal", "Chase");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    double fresh_gbps = aging_traverse(&heap);
+    double fresh_ns = aging_chase(&heap, &rng);
+    take_memory_snapshot(&fresh);
+    print_aging_row("fresh", &heap, &fresh, base.rss_bytes, fresh_gbps, fresh_ns);
+    record_bandwidth("Traversal fresh", fresh_gbps);
+    record_latency("Chase fresh", live_target, fresh_ns);
+    
+    size_t ops = aging_churn(&heap, seconds, &rng);
+    double aged_gbps = aging_traverse(&heap);
+    double aged_ns = aging_chase(&heap, &rng);
+    take_memory_snapshot(&aged);
+    print_aging_row("aged", &heap, &aged, base.rss_bytes, aged_gbps, aged_ns);
+    snprintf(record_case, sizeof(record_case), "after %d s", seconds);
+    record_bandwidth("Traversal aged", aged_gbps);
+    record_latency("Chase aged", live_target, aged_ns);
+    record_case[0] = '\0';
+    
+    size_t objects = heap.count;
+    aging_heap_free(&heap);
+    take_memory_snapshot(&freed);
+    printf("--------------------------------------------------------------------------------\n");
+    printf("%-34s %zu objects, %zu replacements (%.0f/s)\n", "Churn:", objects, ops, (double)ops / seconds);
+    printf("%-34s %+.1f%% traversal, %+.1f%% chase latency\n", "Aged vs fresh:",
+           100.0 * (aged_gbps - fresh_gbps) / fresh_gbps, 100.0 * (aged_ns - fresh_ns) / fresh_ns);
+    printf("%-34s %.1f MB still resident after freeing everything\n", "Retained by allocator:",
+           freed.rss_bytes > base.rss_bytes ? (freed.rss_bytes - base.rss_bytes) / (1024.0 * 1024.0) : 0.0);
+    printf("%-34s %.0f MB free, %.1f%% in >= 2 MB blocks (%.1f%% before)\n", "System free memory:",
+           aged.free_mb, 100.0 * aged.high_order_share, 100.0 * base.high_order_share);
+}
+
+// ---------------------------------------------------------------------------
+// OpenMP cross-check: the same kernels on the pthread engine and on OpenMP
+// ---------------------------------------------------------------------------
+
+typedef enum { XCHECK_READ, XCHECK_COPY, XCHECK_SCALE, XCHECK_ADD, XCHECK_TRIAD, XCHECK_RANDOM } xcheck_kernel_t;
+
+typedef struct {
+    double* a;
+    double* b;
+    double* c;
+    size_t elements;
+    xcheck_kernel_t kernel;
+    int passes;
+    int* cpus;                  // CPU each thread started on
+    const cpu_set_t* places;    // Per-thread CPU set to pin to, or NULL to run unpinned
+} xcheck_args_t;
+
+// One thread's slice [begin, end) of a streaming kernel pass, or its share of
+// random reads of a. Shared by both engines so only the threading differs.
+static uint64_t xcheck_kernel_slice(const xcheck_args_t* args, size_t begin, size_t end, uint64_t* rng) {
+    double* a = args->a;
+    double* b = args->b;
+    double* c = args->c;
+    double sum = 0.0;
+    switch (args->kernel) {
+    case XCHECK_READ:
+        for (size_t i = begin; i < end; i++) sum += a[i];
+        break;
+    case XCHECK_COPY:
+        for (size_t i = begin; i < end; i++) c[i] = a[i];
+        break;
+    case XCHECK_SCALE:
+        for (size_t i = begin; i < end; i++) b[i] = XCHECK_SCALAR * c[i];
+        break;
+    case XCHECK_ADD:
+        for (size_t i = begin; i < end; i++) c[i] = a[i] + b[i];
+        break;
+    case XCHECK_TRIAD:
+        for (size_t i = begin; i < end; i++) a[i] = b[i] + XCHECK_SCALAR * c[i];
+        break;
+    case XCHECK_RANDOM:
+        for (size_t i = begin; i < end; i++) sum += a[xorshift64(rng) % args->elements];
+        break;
+    }
+    return (uint64_t)sum;
+}
+
+void xcheck_pthread_worker(thread_ctx_t* ctx) {
+    xcheck_args_t* args = (xcheck_args_t*)ctx->shared;
+    int random = args->kernel == XCHECK_RANDOM;
+    size_t begin = random ? 0 : args->elements * ctx->thread_id / ctx->num_threads;
+    size_t end = random ? RANDOM_ACCESSES : args->elements * (ctx->thread_id + 1) / ctx->num_threads;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL * (ctx->thread_id + 1);
+    uint64_t sink = 0;
+    if (args->places) {
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &args->places[ctx->thread_id]);
+    }
+    if (args->cpus) args->cpus[ctx->thread_id] = sched_getcpu();
+    
+    thread_timed_begin(ctx);
+    for (int pass = 0; pass < args->passes; pass++) {
+        sink += xcheck_kernel_slice(args, begin, end, &rng);
+    }
+    thread_timed_end(ctx);
+    ctx->sink = sink;
+}
+
+void xcheck_empty_worker(thread_ctx_t* ctx) {
+    thread_timed_begin(ctx);
+    thread_timed_end(ctx);
+}
+
+#ifdef _OPENMP
+// One parallel region per pass with a static schedule, the usual OpenMP form,
+// so fork/join and the implicit barrier are part of the measured time
+double xcheck_openmp_run(xcheck_args_t* args, int num_threads, uint64_t* sink_out) {
+    uint64_t sink = 0;
+    double start_time = get_time();
+    for (int pass = 0; pass < args->passes; pass++) {
+        #pragma omp parallel num_threads(num_threads) reduction(+:sink)
+        {
+            int tid = omp_get_thread_num();
+            int threads = omp_get_num_threads();
+            uint64_t rng = 0x9E3779B97F4A7C15ULL * (tid + 1) + pass;
+            if (args->kernel == XCHECK_RANDOM) {
+                sink += xcheck_kernel_slice(args, 0, RANDOM_ACCESSES, &rng);
+            } else {
+                size_t begin = args->elements * tid / threads;
+                size_t end = args->elements * (tid + 1) / threads;
+                sink += xcheck_kernel_slice(args, begin, end, &rng);
+            }
+        }
+    }
+    double elapsed = get_time() - start_time;
+    if (sink_out) *sink_out = sink;
+    return elapsed;
+}
+
+const char* openmp_bind_name(omp_proc_bind_t bind) {
+    switch (bind) {
+    case omp_proc_bind_false: return "false";
+    case omp_proc_bind_true: return "true";
+    case omp_proc_bind_master: return "primary";
+    case omp_proc_bind_close: return "close";
+    case omp_proc_bind_spread: return "spread";
+    default: return "unknown";
+    }
+}
+
+// CPUs of each thread's OpenMP place, and their union. Returns NULL when the
+// runtime does not bind threads to places.
+cpu_set_t* openmp_place_sets(const int* place_nums, int num_threads, cpu_set_t* all_places) {
+    for (int t = 0; t < num_threads; t++) {
+        if (place_nums[t] < 0) return NULL;
+    }
+    cpu_set_t* sets = calloc(num_threads, sizeof(cpu_set_t));
+    if (!sets) return NULL;
+    CPU_ZERO(all_places);
+    for (int p = 0; p < omp_get_num_places(); p++) {
+        int ids[CPU_SETSIZE];
+        int n = omp_get_place_num_procs(p);
+        if (n > CPU_SETSIZE) n = CPU_SETSIZE;
+        omp_get_place_proc_ids(p, ids);
+        for (int i = 0; i < n; i++) {
+            CPU_SET(ids[i], all_places);
+            for (int t = 0; t < num_threads; t++) {
+                if (place_nums[t] == p) CPU_SET(ids[i], &sets[t]);
+            }
+        }
+    }
+    return sets;
+}
+
+void print_cpu_placement(const char* label, const int* cpus, int count) {
+    printf("%-8s CPUs:", label);
+    for (int i = 0; i < count; i++) printf(" %d", cpus[i]);
+    printf("\n");
+}
+#endif
+
+void run_openmp_tests(size_t size, int num_threads) {
+    printf("\nRunning OpenMP cross-check tests (%d thread%s)...\n", num_threads, num_threads == 1 ? "" : "s");
+#ifdef _OPENMP
+    static const char* kernel_names[] = {"Sequential Read", "STREAM Copy", "STREAM Scale", "STREAM Add",
+                                         "STREAM Triad", "Random Read"};
+    static const int bytes_per_element[] = {8, 16, 16, 24, 24, 0};  // STREAM counting, no write-allocate
+    const char* bind_env = getenv("OMP_PROC_BIND");
+    const char* places_env = getenv("OMP_PLACES");
+    printf("OMP_PROC_BIND=%s OMP_PLACES=%s (runtime policy: %s, %d places)\n",
+           bind_env ? bind_env : "(unset)", places_env ? places_env : "(unset)",
+           openmp_bind_name(omp_get_proc_bind()), omp_get_num_places());
+    
+    xcheck_args_t args = {0};
+    args.elements = size / sizeof(double);
+    args.passes = ITERATIONS;
+    args.a = aligned_malloc(64, args.elements * sizeof(double));
+    args.b = aligned_malloc(64, args.elements * sizeof(double));
+    args.c = aligned_malloc(64, args.elements * sizeof(double));
+    args.cpus = calloc(num_threads, sizeof(int));
+    int* omp_cpus = calloc(num_threads, sizeof(int));
+    int* omp_place_nums = calloc(num_threads, sizeof(int));
+    if (!args.a || !args.b || !args.c || !args.cpus || !omp_cpus || !omp_place_nums) {
+        fprintf(stderr, "Failed to allocate OpenMP cross-check arrays\n");
+        free(args.a);
+        free(args.b);
+        free(args.c);
+        free(args.cpus);
+        free(omp_cpus);
+        free(omp_place_nums);
+        return;
+    }
+    
+    // First touch with the OpenMP static split, which matches the pthread slices
+    #pragma omp parallel num_threads(num_threads)
+    {
+        int tid = omp_get_thread_num();
+        int threads = omp_get_num_threads();
+        size_t begin = args.elements * tid / threads;
+        size_t end = args.elements * (tid + 1) / threads;
+        for (size_t i = begin; i < end; i++) {
+            args.a[i] = 1.0;
+            args.b[i] = 2.0;
+            args.c[i] = 0.0;
+        }
+        omp_cpus[tid] = sched_getcpu();
+        omp_place_nums[tid] = omp_get_place_num();
+    }
+    printf("Arrays: 3 x %zu MB, %d passes per kernel\n", size / (1024 * 1024), ITERATIONS);
+    
+    // With binding, the runtime pins this thread to place 0 at startup and
+    // pthreads would inherit that one place. Widen this thread to all places
+    // and pin each pthread worker to the place of the same OpenMP thread.
+    cpu_set_t saved_affinity, all_places;
+    pthread_getaffinity_np(pthread_self(), sizeof(saved_affinity), &saved_affinity);
+    cpu_set_t* place_sets = openmp_place_sets(omp_place_nums, num_threads, &all_places);
+    if (place_sets) {
+        pthread_setaffinity_np(pthread_self(), sizeof(all_places), &all_places);
+        args.places = place_sets;
+        printf("pthread workers pinned to the CPUs of the matching OpenMP thread's place\n");
+    } else {
+        printf("OpenMP threads are not bound to places; pthread workers run unpinned\n");
+    }
+    
+    uint64_t sink = 0;
+    printf("%-16s %14s %14s %10s\n", "Kernel", "pthread", "OpenMP", "OMP/pthr");
+    printf("--------------------------------------------------------------------------------\n");
+    for (int k = XCHECK_READ; k <= XCHECK_RANDOM; k++) {
+        args.kernel = (xcheck_kernel_t)k;
+        double pthread_time = run_threaded(num_threads, xcheck_pthread_worker, &args, &sink);
+        double openmp_time = xcheck_openmp_run(&args, num_threads, &sink);
+        if (pthread_time <= 0 || openmp_time <= 0) {
+            fprintf(stderr, "%s: measurement failed\n", kernel_names[k]);
+            continue;
+        }
+        double pthread_rate, openmp_rate;
+        const char* unit;
+        if (k == XCHECK_RANDOM) {
+            double accesses = (double)RANDOM_ACCESSES * num_threads * ITERATIONS;
+            pthread_rate = accesses / pthread_time / 1e6;
+            openmp_rate = accesses / openmp_time / 1e6;
+            unit = "MIOPS";
+        } else {
+            double bytes = (double)args.elements * bytes_per_element[k] * ITERATIONS;
+            pthread_rate = bytes / pthread_time / (1024.0 * 1024.0 * 1024.0);
+            openmp_rate = bytes / openmp_time / (1024.0 * 1024.0 * 1024.0);
+            unit = "GB/s";
+            record_bandwidth(kernel_names[k], pthread_rate);
+        }
+        printf("%-16s %8.2f %-5s %8.2f %-5s %9.2fx\n", kernel_names[k],
+               pthread_rate, unit, openmp_rate, unit, openmp_rate / pthread_rate);
+    }
+    
+    // Fork/join cost: the pthread engine creates its threads per run, OpenMP keeps a pool
+    run_threaded(num_threads, xcheck_empty_worker, NULL, NULL);
+    double start_time = get_time();
+    for (int r = 0; r < XCHECK_EMPTY_REGIONS; r++) {
+        run_threaded(num_threads, xcheck_empty_worker, NULL, NULL);
+    }
+    double pthread_region = (get_time() - start_time) / XCHECK_EMPTY_REGIONS;
+    int region_threads = 0;
+    start_time = get_time();
+    for (int r = 0; r < XCHECK_EMPTY_REGIONS; r++) {
+        #pragma omp parallel num_threads(num_threads)
+        {
+            if (omp_get_thread_num() == 0) region_threads = omp_get_num_threads();
+        }
+    }
+    double openmp_region = (get_time() - start_time) / XCHECK_EMPTY_REGIONS;
+    printf("%-16s %8.2f %-5s %8.2f %-5s %9.2fx\n", "Empty region",
+           pthread_region * 1e6, "us", openmp_region * 1e6, "us", openmp_region / pthread_region);
+    
+    if (region_threads != num_threads) {
+        printf("OpenMP ran %d of %d threads per region (OMP_DYNAMIC or thread limit)\n", region_threads, num_threads);
+    }
+    
+    pthread_setaffinity_np(pthread_self(), sizeof(saved_affinity), &saved_affinity);
+    
+    printf("\nThread placement:\n");
+    print_cpu_placement("pthread", args.cpus, num_threads);
+    print_cpu_placement("OpenMP", omp_cpus, num_threads);
+    
+    free(args.a);
+    free(args.b);
+    free(args.c);
+    free(args.cpus);
+    free(omp_cpus);
+    free(omp_place_nums);
+    free(place_sets);
+#else
+    (void)size;
+    (void)num_threads;
+    printf("Skipped: built without OpenMP (use make test_mem_bandwidth_omp)\n");
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// HTML report: latency curve, thread scaling and topology as inline SVG
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    int threads[REPORT_MAX_THREAD_STEPS];
+    int num_steps;
+    double gbps[3][REPORT_MAX_THREAD_STEPS];  // Read, copy, triad
+} report_sweep_t;
+
+static const xcheck_kernel_t report_sweep_kernels[3] = {XCHECK_READ, XCHECK_COPY, XCHECK_TRIAD};
+static const char* report_sweep_names[3] = {"Sequential Read", "STREAM Copy", "STREAM Triad"};
+static const int report_sweep_bytes[3] = {8, 16, 24};  // Bytes moved per element
+static const char* report_colors[] = {"#1f77b4", "#ff7f0e", "#2ca02c", "#d62728", "#9467bd", "#8c564b"};
+
+void format_bytes(size_t bytes, char* out, size_t out_size) {
+    if (bytes >= MB_TO_BYTES(1)) {
+        snprintf(out, out_size, "%.3g MB", bytes / (1024.0 * 1024.0));
+    } else {
+        snprintf(out, out_size, "%.3g KB", bytes / 1024.0);
+    }
+}
+
+// Tick spacing of 1, 2 or 5 times a power of ten giving about `ticks` ticks
+double report_tick_step(double max, int ticks) {
+    double raw = max / ticks;
+    double magnitude = pow(10.0, floor(log10(raw)));
+    double norm = raw / magnitude;
+    return (norm <= 1.0 ? 1.0 : norm <= 2.0 ? 2.0 : norm <= 5.0 ? 5.0 : 10.0) * magnitude;
+}
+
+// Thread scaling of the pthread engine: 1, 2, 4, ... threads and num_threads
+void run_report_sweep(size_t size, int num_threads, report_sweep_t* sweep) {
+    xcheck_args_t args = {0};
+    args.elements = size / sizeof(double);
+    args.passes = ITERATIONS;
+    args.a = aligned_malloc(64, args.elements * sizeof(double));
+    args.b = aligned_malloc(64, args.elements * sizeof(double));
+    args.c = aligned_malloc(64, args.elements * sizeof(double));
+    args.cpus = calloc(num_threads, sizeof(int));
+    sweep->num_steps = 0;
+    if (!args.a || !args.b || !args.c || !args.cpus) {
+        fprintf(stderr, "Failed to allocate report sweep arrays\n");
+        free(args.a);
+        free(args.b);
+        free(args.c);
+        free(args.cpus);
+        return;
+    }
+    for (size_t i = 0; i < args.elements; i++) {
+        args.a[i] = 1.0;
+        args.b[i] = 2.0;
+        args.c[i] = 0.0;
+    }
+    
+    for (int t = 1; sweep->num_steps < REPORT_MAX_THREAD_STEPS; t *= 2) {
+        if (t > num_threads) t = num_threads;
+        sweep->threads[sweep->num_steps++] = t;
+        if (t == num_threads) break;
+    }
+    printf("\nRunning report thread sweep (3 arrays of %zu MB)...\n", size / (1024 * 1024));
+    printf("%-16s", "Threads");
+    for (int s = 0; s < sweep->num_steps; s++) printf(" %8d", sweep->threads[s]);
+    printf("   (GB/s)\n");
+    printf("--------------------------------------------------------------------------------\n");
+    for (int k = 0; k < 3; k++) {
+        args.kernel = report_sweep_kernels[k];
+        printf("%-16s", report_sweep_names[k]);
+        for (int s = 0; s < sweep->num_steps; s++) {
+            double t = run_threaded(sweep->threads[s], xcheck_pthread_worker, &args, NULL);
+            double gb = (double)args.elements * report_sweep_bytes[k] * ITERATIONS / (1024.0 * 1024.0 * 1024.0);
+            sweep->gbps[k][s] = t > 0 ? gb / t : 0.0;
+            printf(" %8.2f", sweep->gbps[k][s]);
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+    
+    free(args.a);
+    free(args.b);
+    free(args.c);
+    free(args.cpus);
+}
+
+// Plot area of a chart; x is log2 bytes for the latency chart, an index otherwise
+typedef struct {
+    double w, h, left, right, top, bottom;
+    double xmin, xmax, ymax;
+} svg_axes_t;
+
+static double axes_x(const svg_axes_t* a, double x) {
+    return a->left + (x - a->xmin) / (a->xmax - a->xmin) * (a->w - a->left - a->right);
+}
+
+static double axes_y(const svg_axes_t* a, double y) {
+    return a->h - a->bottom - y / a->ymax * (a->h - a->top - a->bottom);
+}
+
+// Horizontal grid lines and labels every `step` up to ymax, plus the y-axis title
+static void svg_y_grid(FILE* f, const svg_axes_t* a, double step, const char* title) {
+    for (double y = 0; y <= a->ymax + step / 2; y += step) {
+        fprintf(f, "<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"#ddd\"/>"
+                "<text x=\"%.1f\" y=\"%.1f\" text-anchor=\"end\">%g</text>\n",
+                a->left, axes_y(a, y), a->w - a->right, axes_y(a, y), a->left - 6, axes_y(a, y) + 4, y);
+    }
+    double mid = (a->top + a->h - a->bottom) / 2;
+    fprintf(f, "<text x=\"14\" y=\"%.1f\" text-anchor=\"middle\" transform=\"rotate(-90 14 %.1f)\">%s</text>\n",
+            mid, mid, title);
+    fprintf(f, "<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"#333\"/>\n",
+            a->left, a->h - a->bottom, a->w - a->right, a->h - a->bottom);
+}
+
+// Text with the HTML special characters escaped
+static void html_text(FILE* f, const char* s) {
+    for (; *s; s++) {
+        switch (*s) {
+        case '<': fputs("&lt;", f); break;
+        case '>': fputs("&gt;", f); break;
+        case '&': fputs("&amp;", f); break;
+        case '"': fputs("&quot;", f); break;
+        default: fputc(*s, f);
+        }
+    }
+}
+
+static int compare_report_size(const void* a, const void* b) {
+    size_t x = ((const report_result_t*)a)->size;
+    size_t y = ((const report_result_t*)b)->size;
+    return (x > y) - (x < y);
+}
+
+// Latency sweep results; other suites record latency at unrelated sizes
+static int is_latency_sweep(const report_result_t* r) {
+    return strcmp(r->suite, "baseline") == 0 && r->size > 0;
+}
+
+// Table of recorded results with their suite, in run order; skip_sweep
+// leaves out the latency sweep already plotted
+void report_results_table(FILE* f, const char* title, const char* unit, const report_series_t* series,
+                          int skip_sweep) {
+    int rows = 0;
+    for (int i = 0; i < series->count; i++) rows += !(skip_sweep && is_latency_sweep(&series->items[i]));
+    if (rows == 0) return;
+    fprintf(f, "<h2>%s</h2>\n<table>\n<tr><th>Suite</th><th>Test</th><th>%s</th></tr>\n", title, unit);
+    for (int i = 0; i < series->count; i++) {
+        const report_result_t* r = &series->items[i];
+        if (skip_sweep && is_latency_sweep(r)) continue;
+        fprintf(f, "<tr><td>");
+        html_text(f, r->suite);
+        fprintf(f, "</td><td>");
+        html_text(f, r->label);
+        fprintf(f, "</td><td class=\"num\">%.3f</td></tr>\n", r->value);
+    }
+    fprintf(f, "</table>\n");
+}
+
+// Latency against buffer size on a log2 axis, with dashed lines at each
+// data cache capacity
+void report_latency_svg(FILE* f) {
+    report_result_t* pts = malloc(report_latency.count * sizeof(report_result_t));
+    if (!pts) return;
+    int n = 0;
+    for (int i = 0; i < report_latency.count; i++) {
+        if (is_latency_sweep(&report_latency.items[i])) pts[n++] = report_latency.items[i];
+    }
+    qsort(pts, n, sizeof(report_result_t), compare_report_size);
+    
+    svg_axes_t a = {760, 360, 60, 20, 20, 50, 0, 0, 0};
+    a.xmin = floor(log2((double)pts[0].size));
+    a.xmax = ceil(log2((double)pts[n - 1].size));
+    if (a.xmax <= a.xmin) a.xmax = a.xmin + 1;
+    for (int i = 0; i < n; i++) {
+        if (pts[i].value > a.ymax) a.ymax = pts[i].value;
+    }
+    double ystep = report_tick_step(a.ymax, 5);
+    a.ymax = ceil(a.ymax / ystep) * ystep;
+    
+    fprintf(f, "<svg width=\"%.0f\" height=\"%.0f\" font-family=\"sans-serif\" font-size=\"11\">\n", a.w, a.h);
+    svg_y_grid(f, &a, ystep, "ns/access");
+    int label_every = a.xmax - a.xmin > 12 ? 2 : 1;
+    for (int e = (int)a.xmin; e <= (int)a.xmax; e++) {
+        char label[16];
+        double x = axes_x(&a, e);
+        format_bytes((size_t)1 << e, label, sizeof(label));
+        fprintf(f, "<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"#999\"/>",
+                x, a.h - a.bottom, x, a.h - a.bottom + 4);
+        if ((e - (int)a.xmin) % label_every == 0) {
+            fprintf(f, "<text x=\"%.1f\" y=\"%.1f\" text-anchor=\"middle\">%s</text>", x, a.h - a.bottom + 16, label);
+        }
+        fprintf(f, "\n");
+    }
+    fprintf(f, "<text x=\"%.1f\" y=\"%.1f\" text-anchor=\"middle\">Buffer size</text>\n",
+            (a.left + a.w - a.right) / 2, a.h - 12);
+    
+    int marked = 0;
+    for (int i = 0; i < num_cache_levels; i++) {
+        if (strcmp(cache_levels[i].type, "Instruction") == 0) continue;
+        size_t bytes = cache_levels[i].size_kb * 1024;
+        double x = log2((double)bytes);
+        if (x < a.xmin || x > a.xmax) continue;
+        char size_str[16];
+        format_bytes(bytes, size_str, sizeof(size_str));
+        fprintf(f, "<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"#c33\" stroke-dasharray=\"4 3\"/>"
+                "<text x=\"%.1f\" y=\"%.1f\" fill=\"#c33\">L%d %s</text>\n",
+                axes_x(&a, x), a.top, axes_x(&a, x), a.h - a.bottom,
+                axes_x(&a, x) + 3, a.top + 10 + 12 * (marked++ % 2), cache_levels[i].level, size_str);
+    }
+    
+    fprintf(f, "<polyline fill=\"none\" stroke=\"%s\" stroke-width=\"2\" points=\"", report_colors[0]);
+    for (int i = 0; i < n; i++) {
+        fprintf(f, "%.1f,%.1f ", axes_x(&a, log2((double)pts[i].size)), axes_y(&a, pts[i].value));
+    }
+    fprintf(f, "\"/>\n");
+    for (int i = 0; i < n; i++) {
+        fprintf(f, "<circle cx=\"%.1f\" cy=\"%.1f\" r=\"3.5\" fill=\"%s\"><title>",
+                axes_x(&a, log2((double)pts[i].size)), axes_y(&a, pts[i].value), report_colors[0]);
+        html_text(f, pts[i].label);
+        fprintf(f, ": %.1f ns</title></circle>\n", pts[i].value);
+    }
+    fprintf(f, "</svg>\n");
+    free(pts);
+}
+
+// Grouped bars: one group per kernel, one bar per thread count
+void report_sweep_svg(FILE* f, const report_sweep_t* sweep) {
+    svg_axes_t a = {760, 320, 60, 140, 20, 40, 0, 3, 0};
+    for (int k = 0; k < 3; k++) {
+        for (int s = 0; s < sweep->num_steps; s++) {
+            if (sweep->gbps[k][s] > a.ymax) a.ymax = sweep->gbps[k][s];
+        }
+    }
+    if (a.ymax <= 0) return;
+    double ystep = report_tick_step(a.ymax, 5);
+    a.ymax = ceil(a.ymax / ystep) * ystep;
+    double group_w = axes_x(&a, 1) - axes_x(&a, 0);
+    double bar_w = group_w * 0.8 / sweep->num_steps;
+    
+    fprintf(f, "<svg width=\"%.0f\" height=\"%.0f\" font-family=\"sans-serif\" font-size=\"11\">\n", a.w, a.h);
+    svg_y_grid(f, &a, ystep, "GB/s");
+    for (int k = 0; k < 3; k++) {
+        double gx = axes_x(&a, k) + group_w * 0.1;
+        for (int s = 0; s < sweep->num_steps; s++) {
+            double v = sweep->gbps[k][s];
+            fprintf(f, "<rect x=\"%.1f\" y=\"%.1f\" width=\"%.1f\" height=\"%.1f\" fill=\"%s\">"
+                    "<title>%s, %d thread%s: %.2f GB/s</title></rect>\n",
+                    gx + s * bar_w, axes_y(&a, v), bar_w * 0.9, a.h - a.bottom - axes_y(&a, v), report_colors[s % 6],
+                    report_sweep_names[k], sweep->threads[s], sweep->threads[s] == 1 ? "" : "s", v);
+        }
+        fprintf(f, "<text x=\"%.1f\" y=\"%.1f\" text-anchor=\"middle\">%s</text>\n",
+                axes_x(&a, k + 0.5), a.h - a.bottom + 16, report_sweep_names[k]);
+    }
+    for (int s = 0; s < sweep->num_steps; s++) {
+        double y = a.top + 16 * s;
+        fprintf(f, "<rect x=\"%.1f\" y=\"%.1f\" width=\"10\" height=\"10\" fill=\"%s\"/>"
+                "<text x=\"%.1f\" y=\"%.1f\">%d thread%s</text>\n",
+                a.w - a.right + 20, y, report_colors[s % 6], a.w - a.right + 36, y + 9,
+                sweep->threads[s], sweep->threads[s] == 1 ? "" : "s");
+    }
+    fprintf(f, "</svg>\n");
+}
+
+// Cache levels as nested boxes, widths on a log scale from L1 to the LLC
+void report_topology_svg(FILE* f) {
+    const double w = 760, row_h = 34, left = 10;
+    double h = (num_cache_levels + 1) * row_h + 10;
+    double max_log = 1;
+    for (int i = 0; i < num_cache_levels; i++) {
+        double l = log2((double)cache_levels[i].size_kb + 1);
+        if (l > max_log) max_log = l;
+    }
+    fprintf(f, "<svg width=\"%.0f\" height=\"%.0f\" font-family=\"sans-serif\" font-size=\"12\">\n", w, h);
+    for (int i = 0; i < num_cache_levels; i++) {
+        const cache_info_t* c = &cache_levels[i];
+        int cpus[1024];
+        int shared = read_cache_shared_cpus(0, c->level, cpus, 1024);
+        char size_str[16];
+        format_bytes(c->size_kb * 1024, size_str, sizeof(size_str));
+        double bw = (w - 2 * left) * (0.25 + 0.75 * log2((double)c->size_kb + 1) / max_log);
+        double y = 5 + i * row_h;
+        fprintf(f, "<rect x=\"%.1f\" y=\"%.1f\" width=\"%.1f\" height=\"%.1f\" fill=\"%s\" fill-opacity=\"0.25\" stroke=\"%s\"/>"
+                "<text x=\"%.1f\" y=\"%.1f\">L%d %s: %s, %d-way, %d B lines, shared by %d CPU%s</text>\n",
+                left, y, bw, row_h - 6, report_colors[(c->level - 1) % 6], report_colors[(c->level - 1) % 6],
+                left + 8, y + 18, c->level, c->type, size_str, c->associativity, c->line_size,
+                shared, shared == 1 ? "" : "s");
+    }
+    double y = 5 + num_cache_levels * row_h;
+    fprintf(f, "<rect x=\"%.1f\" y=\"%.1f\" width=\"%.1f\" height=\"%.1f\" fill=\"#888\" fill-opacity=\"0.25\" stroke=\"#888\"/>"
+            "<text x=\"%.1f\" y=\"%.1f\">DRAM</text>\n", left, y, w - 2 * left, row_h - 6, left + 8, y + 18);
+    fprintf(f, "</svg>\n");
+}
+
+// Value of "key: value" from a /proc file such as /proc/cpuinfo
+void read_proc_field(const char* path, const char* key, char* out, size_t out_size) {
+    char line[512];
+    size_t key_len = strlen(key);
+    snprintf(out, out_size, "unknown");
+    FILE* fp = fopen(path, "r");
+    if (!fp) return;
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, key, key_len) != 0) continue;
+        char* value = strchr(line, ':');
+        if (!value) continue;
+        value++;
+        while (*value == ' ' || *value == '\t') value++;
+        value[strcspn(value, "\n")] = '\0';
+        snprintf(out, out_size, "%s", value);
+        break;
+    }
+    fclose(fp);
+}
+
+// Write the report; returns 0 on success
+int write_html_report(const char* path, size_t buffer_size, const report_sweep_t* sweep) {
+    FILE* f = fopen(path, "w");
+    if (!f) return -1;
+    char host[256] = "unknown", cpu_model[256], mem_total[64], date[64];
+    gethostname(host, sizeof(host));
+    read_proc_field("/proc/cpuinfo", "model name", cpu_model, sizeof(cpu_model));
+    read_proc_field("/proc/meminfo", "MemTotal", mem_total, sizeof(mem_total));
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    
+    fprintf(f, "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>Memory benchmark: ");
+    html_text(f, host);
+    fprintf(f, "</title>\n<style>body{font-family:sans-serif;margin:2em;max-width:820px}table{border-collapse:collapse}"
+            "td,th{border:1px solid #ccc;padding:3px 8px;text-align:left}td.num{text-align:right}</style>\n"
+            "</head><body>\n");
+    fprintf(f, "<h1>Memory benchmark report</h1>\n<table>\n<tr><th>Host</th><td>");
+    html_text(f, host);
+    fprintf(f, "</td></tr>\n<tr><th>CPU</th><td>");
+    html_text(f, cpu_model);
+    fprintf(f, "</td></tr>\n");
+    fprintf(f, "<tr><th>CPUs online</th><td>%ld</td></tr>\n<tr><th>Memory</th><td>%s</td></tr>\n",
+            sysconf(_SC_NPROCESSORS_ONLN), mem_total);
+    fprintf(f, "<tr><th>Buffer size</th><td>%zu MB</td></tr>\n<tr><th>Date</th><td>%s</td></tr>\n</table>\n",
+            buffer_size / (1024 * 1024), date);
+    
+    fprintf(f, "<h2>Cache topology</h2>\n");
+    if (num_cache_levels > 0) {
+        report_topology_svg(f);
+    } else {
+        fprintf(f, "<p>Cache information not available.</p>\n");
+    }
+    
+    fprintf(f, "<h2>Latency by buffer size</h2>\n");
+    int sweep_points = 0;
+    for (int i = 0; i < report_latency.count; i++) sweep_points += is_latency_sweep(&report_latency.items[i]);
+    if (sweep_points > 0) {
+        report_latency_svg(f);
+        fprintf(f, "<p>Dependent pointer chase, %d accesses per size. Dashed lines mark data cache capacities.</p>\n",
+                LATENCY_ACCESSES);
+    }
+    
+    fprintf(f, "<h2>Bandwidth by kernel and thread count</h2>\n");
+    if (sweep->num_steps > 0) {
+        report_sweep_svg(f, sweep);
+        fprintf(f, "<p>pthread engine, three arrays of %zu MB, STREAM byte counting.</p>\n", buffer_size / (1024 * 1024));
+    }
+    
+    report_results_table(f, "All bandwidth results", "GB/s", &report_bandwidth, 0);
+    report_results_table(f, "Other latency results", "ns", &report_latency, 1);
+    fprintf(f, "</body></html>\n");
+    
+    int failed = ferror(f);
+    if (fclose(f) != 0) failed = 1;
+    return failed ? -1 : 0;
+}
+
+// ---------------------------------------------------------------------------
+// Results history: append-only JSONL per run, trend and change-point queries
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    char test[HISTORY_TEST_CHARS];
+    time_t* ts;
+    double* values;
+    int count;
+    int capacity;
+} history_series_t;
+
+static uint64_t fnv1a(const char* s) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (; *s; s++) {
+        hash ^= (unsigned char)*s;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Hash of the host name, CPU model, CPU count and caches, so a host keeps its
+// fingerprint across reboots, kernel and firmware updates but not hardware
+// changes. Cache entries are summed since the size sweep reorders them.
+uint64_t host_fingerprint(void) {
+    char cpu_model[256], host[256] = "";
+    char buffer[600];
+    read_proc_field("/proc/cpuinfo", "model name", cpu_model, sizeof(cpu_model));
+    gethostname(host, sizeof(host));
+    snprintf(buffer, sizeof(buffer), "%s|%s|%ld", host, cpu_model, sysconf(_SC_NPROCESSORS_ONLN));
+    uint64_t hash = fnv1a(buffer);
+    for (int i = 0; i < num_cache_levels; i++) {
+        snprintf(buffer, sizeof(buffer), "L%d|%s|%zu", cache_levels[i].level, cache_levels[i].type,
+                 cache_levels[i].size_kb);
+        hash += fnv1a(buffer);
+    }
+    return hash;
+}
+
+// Test id of one recorded result: kind, config, suite and case-qualified
+// label. A label still repeated within one suite falls back to #2, #3...
+static void history_test_id(char* out, size_t out_size, const char* kind, const char* config,
+                            const report_series_t* series, int index) {
+    const report_result_t* r = &series->items[index];
+    int occurrence = 1;
+    for (int i = 0; i < index; i++) {
+        if (strcmp(series->items[i].suite, r->suite) == 0 && strcmp(series->items[i].label, r->label) == 0) {
+            occurrence++;
+        }
+    }
+    if (occurrence > 1) {
+        snprintf(out, out_size, "%s/%s%s/%s#%d", kind, config, r->suite, r->label, occurrence);
+    } else {
+        snprintf(out, out_size, "%s/%s%s/%s", kind, config, r->suite, r->label);
+    }
+}
+
+static void json_string(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+// Append every result recorded this run, one JSON object per line.
+// Returns the number of lines written or -1.
+int append_history(const char* path, size_t buffer_size, int num_threads) {
+    FILE* f = fopen(path, "a");
+    if (!f) return -1;
+    uint64_t host = host_fingerprint();
+    long long ts = (long long)time(NULL);
+    char config[32], test[HISTORY_TEST_CHARS];
+    int written = 0;
+    
+    for (int i = 0; i < report_latency.count; i++) {
+        history_test_id(test, sizeof(test), "latency", "", &report_latency, i);
+        fprintf(f, "{\"ts\":%lld,\"host\":\"%016llx\",\"test\":", ts, (unsigned long long)host);
+        json_string(f, test);
+        fprintf(f, ",\"value\":%.6g}\n", report_latency.items[i].value);
+        written++;
+    }
+    // Bandwidth depends on the buffer size and thread count, so they are part of the id
+    snprintf(config, sizeof(config), "%zuMB/%dT/", buffer_size / (1024 * 1024), num_threads);
+    for (int i = 0; i < report_bandwidth.count; i++) {
+        history_test_id(test, sizeof(test), "bandwidth", config, &report_bandwidth, i);
+        fprintf(f, "{\"ts\":%lld,\"host\":\"%016llx\",\"test\":", ts, (unsigned long long)host);
+        json_string(f, test);
+        fprintf(f, ",\"value\":%.6g}\n", report_bandwidth.items[i].value);
+        written++;
+    }
+    
+    int failed = ferror(f);
+    if (fclose(f) != 0) failed = 1;
+    return failed ? -1 : written;
+}
+
+// Value of "key" in a flat JSON object line, past the colon and whitespace
+static const char* json_field(const char* line, const char* key) {
+    char quoted[32];
+    snprintf(quoted, sizeof(quoted), "\"%s\"", key);
+    const char* p = strstr(line, quoted);
+    if (!p) return NULL;
+    p += strlen(quoted);
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p++ != ':') return NULL;
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+// JSON string at p into out, undoing backslash escapes; returns 1 on success
+static int json_string_value(const char* p, char* out, size_t out_size) {
+    if (!p || *p++ != '"') return 0;
+    size_t n = 0;
+    for (; *p && *p != '"'; p++) {
+        if (*p == '\\' && p[1]) p++;
+        if (n + 1 >= out_size) return 0;
+        out[n++] = *p;
+    }
+    out[n] = '\0';
+    return *p == '"';
+}
+
+// Parse one history line; returns 1 on success
+static int parse_history_line(const char* line, long long* ts, char* host, size_t host_size,
+                              char* test, size_t test_size, double* value) {
+    const char* t = json_field(line, "ts");
+    const char* v = json_field(line, "value");
+    if (!t || !v) return 0;
+    *ts = strtoll(t, NULL, 10);
+    *value = strtod(v, NULL);
+    return json_string_value(json_field(line, "host"), host, host_size) &&
+           json_string_value(json_field(line, "test"), test, test_size);
+}
+
+static history_series_t* history_find(history_series_t** series, int* count, int* capacity, const char* test) {
+    for (int i = 0; i < *count; i++) {
+        if (strcmp((*series)[i].test, test) == 0) return &(*series)[i];
+    }
+    if (*count == *capacity) {
+        int grown = *capacity ? *capacity * 2 : 64;
+        history_series_t* more = realloc(*series, grown * sizeof(history_series_t));
+        if (!more) return NULL;
+        *series = more;
+        *capacity = grown;
+    }
+    history_series_t* s = &(*series)[(*count)++];
+    memset(s, 0, sizeof(*s));
+    snprintf(s->test, sizeof(s->test), "%s", test);
+    return s;
+}
+
+static int history_push(history_series_t* s, time_t ts, double value) {
+    if (s->count == s->capacity) {
+        int grown = s->capacity ? s->capacity * 2 : 16;
+        time_t* more_ts = realloc(s->ts, grown * sizeof(time_t));
+        if (!more_ts) return 0;
+        s->ts = more_ts;
+        double* more_values = realloc(s->values, grown * sizeof(double));
+        if (!more_values) return 0;
+        s->values = more_values;
+        s->capacity = grown;
+    }
+    s->ts[s->count] = ts;
+    s->values[s->count] = value;
+    s->count++;
+    return 1;
+}
+
+// Least-squares slope in value units per day
+double history_slope_per_day(const history_series_t* s) {
+    double mt = 0, mv = 0, cov = 0, var = 0;
+    for (int i = 0; i < s->count; i++) {
+        mt += (s->ts[i] - s->ts[0]) / 86400.0;
+        mv += s->values[i];
+    }
+    mt /= s->count;
+    mv /= s->count;
+    for (int i = 0; i < s->count; i++) {
+        double dt = (s->ts[i] - s->ts[0]) / 86400.0 - mt;
+        cov += dt * (s->values[i] - mv);
+        var += dt * dt;
+    }
+    return var > 0 ? cov / var : 0.0;
+}
+
+// Binary segmentation: split [begin, end) where the mean shift is most
+// significant, if it passes the t and size thresholds, then recurse.
+// Split indices go to cuts in increasing order.
+void history_change_points(const double* values, int begin, int end, int* cuts, int* num_cuts) {
+    if (end - begin < 2 * HISTORY_MIN_SEGMENT || *num_cuts >= HISTORY_MAX_CHANGES) return;
+    int best = -1;
+    double best_t = 0.0;
+    for (int k = begin + HISTORY_MIN_SEGMENT; k <= end - HISTORY_MIN_SEGMENT; k++) {
+        double m1, s1, m2, s2;
+        mean_stddev(values + begin, k - begin, &m1, &s1);
+        mean_stddev(values + k, end - k, &m2, &s2);
+        if (m1 == 0) continue;
+        double se = sqrt(s1 * s1 / (k - begin) + s2 * s2 / (end - k));
+        double shift = fabs(m2 - m1) / fabs(m1);
+        double t = se > 0 ? fabs(m2 - m1) / se : (shift > 0 ? 1e9 : 0.0);
+        if (shift >= HISTORY_MIN_SHIFT && t > best_t) {
+            best_t = t;
+            best = k;
+        }
+    }
+    if (best < 0 || best_t < HISTORY_CHANGE_T) return;
+    history_change_points(values, begin, best, cuts, num_cuts);
+    if (*num_cuts < HISTORY_MAX_CHANGES) cuts[(*num_cuts)++] = best;
+    history_change_points(values, best, end, cuts, num_cuts);
+}
+
+static void format_day(time_t ts, char* out, size_t out_size) {
+    strftime(out, out_size, "%Y-%m-%d", localtime(&ts));
+}
+
+// Print trend, drift and change points for every metric this host recorded.
+// `since` is the drift reference (0: the first run). Returns 0 on success.
+int run_history_query(const char* path, time_t since) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Failed to open history file %s\n", path);
+        return -1;
+    }
+    char host_id[32];
+    snprintf(host_id, sizeof(host_id), "%016llx", (unsigned long long)host_fingerprint());
+    
+    history_series_t* series = NULL;
+    int num_series = 0, capacity = 0, other_hosts = 0, malformed = 0;
+    long long runs = 0, last_ts = -1;
+    char line[1024], host[32], test[HISTORY_TEST_CHARS];
+    while (fgets(line, sizeof(line), f)) {
+        long long ts;
+        double value;
+        if (!parse_history_line(line, &ts, host, sizeof(host), test, sizeof(test), &value)) {
+            malformed++;
+            continue;
+        }
+        if (strcmp(host, host_id) != 0) {
+            other_hosts++;
+            continue;
+        }
+        if (ts != last_ts) runs++;
+        last_ts = ts;
+        history_series_t* s = history_find(&series, &num_series, &capacity, test);
+        if (!s || !history_push(s, (time_t)ts, value)) {
+            fprintf(stderr, "Out of memory reading history\n");
+            break;
+        }
+    }
+    fclose(f);
+    
+    printf("Results history: %s\n", path);
+    printf("Host fingerprint: %s (%lld runs, %d metrics; %d lines from other hosts, %d malformed)\n",
+           host_id, runs, num_series, other_hosts, malformed);
+    char since_str[48] = "the first run day";
+    if (since > 0) {
+        char day[16];
+        format_day(since, day, sizeof(day));
+        snprintf(since_str, sizeof(since_str), "the first run day from %s", day);
+    }
+    printf("Drift: mean of the last %d runs against the runs on %s\n", HISTORY_RECENT_RUNS, since_str);
+    printf("%-44s %5s %10s %10s %9s %9s\n", "Metric", "Runs", "Latest", "Trend/30d", "Drift", "Changes");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < num_series; i++) {
+        history_series_t* s = &series[i];
+        double mean, sd;
+        mean_stddev(s->values, s->count, &mean, &sd);
+        double trend = mean != 0 ? history_slope_per_day(s) * 30.0 / mean : 0.0;
+        
+        // Reference: runs on the first day at or after `since`
+        int ref_begin = 0;
+        while (ref_begin < s->count && s->ts[ref_begin] < since) ref_begin++;
+        double ref = 0.0, recent = 0.0;
+        int ref_n = 0, recent_n = 0;
+        for (int j = ref_begin; j < s->count && s->ts[j] < s->ts[ref_begin] + 86400; j++, ref_n++) ref += s->values[j];
+        for (int j = s->count - 1; j >= 0 && recent_n < HISTORY_RECENT_RUNS; j--, recent_n++) recent += s->values[j];
+        char drift_str[16] = "n/a";
+        if (ref_n > 0 && ref != 0) {
+            snprintf(drift_str, sizeof(drift_str), "%+.1f%%", 100.0 * ((recent / recent_n) / (ref / ref_n) - 1.0));
+        }
+        
+        int cuts[HISTORY_MAX_CHANGES];
+        int num_cuts = 0;
+        history_change_points(s->values, 0, s->count, cuts, &num_cuts);
+        
+        char trend_str[16] = "n/a";
+        if (s->ts[s->count - 1] - s->ts[0] >= HISTORY_MIN_TREND_DAYS * 86400) snprintf(trend_str, sizeof(trend_str), "%+.2f%%", 100.0 * trend);
+        printf("%-44.44s %5d %10.3f %10s %9s %9d\n", s->test, s->count, s->values[s->count - 1],
+               trend_str, drift_str, num_cuts);
+        
+        int prev = 0;
+        for (int c = 0; c < num_cuts; c++) {
+            int next = c + 1 < num_cuts ? cuts[c + 1] : s->count;
+            double before, after, unused;
+            mean_stddev(s->values + prev, cuts[c] - prev, &before, &unused);
+            mean_stddev(s->values + cuts[c], next - cuts[c], &after, &unused);
+            char day[16];
+            format_day(s->ts[cuts[c]], day, sizeof(day));
+            printf("    change at %s: %.3f -> %.3f (%+.1f%%)\n", day, before, after, 100.0 * (after / before - 1.0));
+            prev = cuts[c];
+        }
+    }
+    
+    for (int i = 0; i < num_series; i++) {
+        free(series[i].ts);
+        free(series[i].values);
+    }
+    free(series);
+    return 0;
+}
+
+#ifndef NO_MAIN
+int main(int argc, char* argv[]) {
+    size_t size_mb = DEFAULT_SIZE_MB;
+    int num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int run_checksum = 0;
+    int run_strings = 0;
+    int run_spmv = 0;
+    int run_graph = 0;
+    int run_transpose = 0;
+    int run_stencil = 0;
+    int run_pollution = 0;
+    int run_prefetch = 0;
+    int run_hw_prefetch = 0;
+    int run_inclusivity = 0;
+    int run_replacement = 0;
+    int run_coherence = 0;
+    int run_dram = 0;
+    int run_page_color = 0;
+    int run_trace = 0;
+    int run_numa = 0;
+    int run_migrate = 0;
+    int run_autonuma = 0;
+    int run_aging = 0;
+    int aging_seconds = AGING_SECONDS;
+    int run_openmp = 0;
+    const char* trace_json_path = NULL;
+    const char* report_path = NULL;
+    const char* history_path = NULL;
+    const char* history_query_path = NULL;
+    time_t history_since = 0;
+    
+    // Parse command line arguments
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            num_threads = atoi(argv[++i]);
+            if (num_threads <= 0) {
+                fprintf(stderr, "Invalid thread count specified. Using 1 thread\n");
+                num_threads = 1;
+            }
+        } else if (strcmp(argv[i], "--checksum") == 0) {
+            run_checksum = 1;
+        } else if (strcmp(argv[i], "--strings") == 0) {
+            run_strings = 1;
+        } else if (strcmp(argv[i], "--spmv") == 0) {
+            run_spmv = 1;
+        } else if (strcmp(argv[i], "--graph") == 0) {
+            run_graph = 1;
+        } else if (strcmp(argv[i], "--transpose") == 0) {
+            run_transpose = 1;
+        } else if (strcmp(argv[i], "--stencil") == 0) {
+            run_stencil = 1;
+        } else if (strcmp(argv[i], "--pollution") == 0) {
+            run_pollution = 1;
+        } else if (strcmp(argv[i], "--prefetch") == 0) {
+            run_prefetch = 1;
+        } else if (strcmp(argv[i], "--hw-prefetch") == 0) {
+            run_hw_prefetch = 1;
+        } else if (strcmp(argv[i], "--inclusivity") == 0) {
+            run_inclusivity = 1;
+        } else if (strcmp(argv[i], "--replacement") == 0) {
+            run_replacement = 1;
+        } else if (strcmp(argv[i], "--coherence") == 0) {
+            run_coherence = 1;
+        } else if (strcmp(argv[i], "--dram") == 0) {
+            run_dram = 1;
+        } else if (strcmp(argv[i], "--page-color") == 0) {
+            run_page_color = 1;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            run_trace = 1;
+        } else if (strcmp(argv[i], "--numa") == 0) {
+            run_numa = 1;
+        } else if (strcmp(argv[i], "--migrate") == 0) {
+            run_migrate = 1;
+        } else if (strcmp(argv[i], "--autonuma") == 0) {
+            run_autonuma = 1;
+        } else if (strcmp(argv[i], "--aging") == 0) {
+            run_aging = 1;
+        } else if (strcmp(argv[i], "--aging-seconds") == 0 && i + 1 < argc) {
+            run_aging = 1;
+            aging_seconds = atoi(argv[++i]);
+            if (aging_seconds <= 0) {
+                fprintf(stderr, "Invalid aging duration specified. Using %d seconds\n", AGING_SECONDS);
+                aging_seconds = AGING_SECONDS;
+            }
+        } else if (strcmp(argv[i], "--openmp") == 0) {
+            run_openmp = 1;
+        } else if (strcmp(argv[i], "--trace-json") == 0 && i + 1 < argc) {
+            trace_json_path = argv[++i];
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            report_path = argv[++i];
+        } else if (strcmp(argv[i], "--history") == 0 && i + 1 < argc) {
+            history_path = argv[++i];
+        } else if (strcmp(argv[i], "--history-query") == 0 && i + 1 < argc) {
+            history_query_path = argv[++i];
+        } else if (strcmp(argv[i], "--since") == 0 && i + 1 < argc) {
+            struct tm day = {0};
+            if (sscanf(argv[++i], "%d-%d-%d", &day.tm_year, &day.tm_mon, &day.tm_mday) != 3) {
+                fprintf(stderr, "Invalid date (expected YYYY-MM-DD): %s\n", argv[i]);
+                return 1;
+            }
+            day.tm_year -= 1900;
+            day.tm_mon -= 1;
+            day.tm_isdst = -1;
+            history_since = mktime(&day);
+        } else if (strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            size_mb = atoi(argv[i]);
+            if (size_mb == 0) {
+                fprintf(stderr, "Invalid size specified. Using default %d MB\n", DEFAULT_SIZE_MB);
+                size_mb = DEFAULT_SIZE_MB;
+            }
+        }
+    }
+    if (num_threads <= 0) num_threads = 1;
+    if (history_query_path) {
+        read_cache_info();
+        return run_history_query(history_query_path, history_since) == 0 ? 0 : 1;
+    }
+    if (trace_json_path && trace_enable(num_threads) != 0) {
+        fprintf(stderr, "Failed to allocate trace buffers\n");
+        trace_disable();
+        return 1;
+    }
+    report_enabled = report_path != NULL || history_path != NULL;
+    
+    size_t buffer_size = MB_TO_BYTES(size_mb);
+    
+    printf("Memory Bandwidth Test\n");
+    printf("===========================\n");
+    printf("Buffer size: %zu MB (%zu bytes)\n", size_mb, buffer_size);
+    printf("Iterations: %d\n", ITERATIONS);
+    printf("Random accesses per iteration: %d\n", RANDOM_ACCESSES);
+    printf("CPU cores available: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    
+    // Read and display cache hierarchy information
+    read_cache_info();
+    display_cache_hierarchy();
+    
+    // Initialize random number generator
+    init_random();
+    
+    // Inclusivity changes how latency results are labeled, so probe it first
+    if (run_inclusivity) {
+        run_inclusivity_tests();
+    }
+    
+    // Allocate memory buffers
+    void* buffer1 = aligned_malloc(64, buffer_size);  // 64-byte aligned for cache efficiency
+    void* buffer2 = aligned_malloc(64, buffer_size);
+    
+    if (!buffer1 || !buffer2) {
+        fprintf(stderr, "Failed to allocate memory buffers\n");
+        if (buffer1) free(buffer1);
+        if (buffer2) free(buffer2);
+        return 1;
+    }
+    
+    // Initialize buffers with data
+    printf("Initializing buffers...\n");
+    memset(buffer1, 0xAA, buffer_size);
+    memset(buffer2, 0x55, buffer_size);
+    
+    // Perform tests
+    printf("\nRunning bandwidth tests...\n");
+    printf("%-20s  %-50s\n", "Test", "Bandwidth");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    // Sequential tests
+    double read_time = test_sequential_read(buffer1, buffer_size, ITERATIONS);
+    display_bandwidth("Sequential Read", read_time, buffer_size, ITERATIONS);
+    
+    double write_time = test_sequential_write(buffer1, buffer_size, ITERATIONS);
+    display_bandwidth("Sequential Write", write_time, buffer_size, ITERATIONS);
+    
+    // Random tests
+    double random_read_time = test_random_read(buffer1, buffer_size, ITERATIONS);
+    if (random_read_time > 0) {
+        display_random_bandwidth("Random Read", random_read_time, ITERATIONS);
+    }
+    
+    double random_write_time = test_random_write(buffer1, buffer_size, ITERATIONS);
+    if (random_write_time > 0) {
+        display_random_bandwidth("Random Write", random_write_time, ITERATIONS);
     }
     
     // Memory copy test (measures both read and write)
@@ -664,6 +6963,106 @@ int main(int argc, char* argv[]) {
     // Clean up dynamically allocated memory
     free_dynamic_test_sizes(test_sizes, size_names, num_tests);
     
+    if (run_checksum) {
+        record_set_suite("checksum");
+        run_checksum_tests(num_threads);
+    }
+    
+    if (run_strings) {
+        record_set_suite("strings");
+        run_string_tests();
+    }
+    
+    if (run_spmv) {
+        record_set_suite("spmv");
+        run_spmv_tests(buffer_size, num_threads);
+    }
+    
+    if (run_graph) {
+        record_set_suite("graph");
+        run_graph_tests(buffer_size, num_threads);
+    }
+    
+    if (run_transpose) {
+        record_set_suite("transpose");
+        run_transpose_tests();
+    }
+    
+    if (run_stencil) {
+        record_set_suite("stencil");
+        run_stencil_tests(buffer_size);
+    }
+    
+    if (run_pollution) {
+        record_set_suite("pollution");
+        run_pollution_tests(buffer_size);
+    }
+    
+    if (run_prefetch) {
+        record_set_suite("prefetch");
+        run_prefetch_tests(buffer_size);
+    }
+    
+    if (run_hw_prefetch) {
+        record_set_suite("hw-prefetch");
+        run_msr_prefetch_tests(buffer_size);
+    }
+    
+    if (run_replacement) {
+        record_set_suite("replacement");
+        run_replacement_tests();
+    }
+    
+    if (run_coherence) {
+        record_set_suite("coherence");
+        run_coherence_tests();
+    }
+    
+    if (run_dram) {
+        record_set_suite("dram");
+        run_dram_tests();
+    }
+    
+    if (run_page_color) {
+        record_set_suite("page-color");
+        run_page_color_tests();
+    }
+    
+    if (run_trace) {
+        record_set_suite("trace");
+        run_trace_tests(buffer_size);
+    }
+    
+    if (run_numa) {
+        record_set_suite("numa");
+        run_numa_tests(buffer_size, num_threads);
+    }
+    
+    if (run_migrate) {
+        record_set_suite("migrate");
+        run_migration_tests(buffer_size);
+    }
+    
+    if (run_autonuma) {
+        record_set_suite("autonuma");
+        run_autonuma_tests(buffer_size, num_threads);
+    }
+    
+    if (run_aging) {
+        record_set_suite("aging");
+        run_aging_tests(buffer_size, aging_seconds);
+    }
+    
+    if (run_openmp) {
+        record_set_suite("openmp");
+        run_openmp_tests(buffer_size, num_threads);
+    }
+    
+    report_sweep_t sweep = {0};
+    if (report_path) {
+        run_report_sweep(buffer_size, num_threads, &sweep);
+    }
+    
     printf("\nNotes:\n");
     printf("- Sequential Read/Write: Measures linear memory access patterns\n");
     printf("- Random Read/Write: Measures random memory access patterns\n");
@@ -674,11 +7073,99 @@ int main(int argc, char* argv[]) {
     printf("- Latency tests measure average time per memory access\n");
     printf("- Cache Level indicates the likely memory hierarchy level being accessed\n");
     printf("- Cache hierarchy is detected from /sys/devices/system/cpu/ when available\n");
+    if (run_checksum) {
+        printf("- Checksum tests hash a private buffer per thread; GB/s is aggregate over all threads\n");
+    }
+    if (run_strings) {
+        printf("- String tests count bytes up to the match; memcmp counts both inputs\n");
+    }
+    if (run_spmv) {
+        printf("- SpMV bandwidth counts compulsory traffic (matrix, x and y once); GFLOP/s is 2 x non-zeros\n");
+    }
+    if (run_graph) {
+        printf("- Graph MTEPS counts adjacency entries examined; bytes/edge is CSR plus per-vertex state per edge\n");
+    }
+    if (run_transpose) {
+        printf("- Transpose bandwidth counts each element read once and written once, like Memory Copy\n");
+    }
+    if (run_stencil) {
+        printf("- Stencil effective GB/s counts one read and one write per point per sweep; reuse is modeled\n");
+    }
+    if (run_pollution) {
+        printf("- Pollution inflation is victim latency relative to the run with an idle aggressor\n");
+    }
+    if (run_prefetch) {
+        printf("- Prefetch residency compares probe latency after the last pass with reference chase latencies\n");
+    }
+    if (run_hw_prefetch) {
+        printf("- Hardware prefetcher delta is (off - on) / on; for latency a positive delta is slower\n");
+    }
+    if (run_inclusivity) {
+        printf("- Latency Cache Level labels count L2 + L3 as LLC capacity when the L3 is exclusive\n");
+    }
+    if (run_replacement) {
+        printf("- Replacement hit rates are interpolated from chase latency; the LRU model is exact for the sequence\n");
+    }
+    if (run_coherence) {
+        printf("- Coherence latency is one dependent pass over lines left in each state by the owner; Modified is the HITM cost\n");
+    }
+    if (run_dram) {
+        printf("- DRAM same-bank lines are found by timing flushed load pairs; results assume an open-page controller\n");
+    }
+    if (run_page_color) {
+        printf("- Page colors are physical page numbers modulo (L2 size / ways / page size), read from pagemap\n");
+    }
+    if (run_trace) {
+        printf("- Trace strength is the share of spikes followed by another one period later; Time is the share of runtime lost\n");
+    }
+    if (run_numa) {
+        printf("- NUMA placement samples up to %d pages with move_pages; weighted interleave uses the kernel's sysfs weights\n",
+               NUMA_SAMPLE_PAGES);
+    }
+    if (run_migrate) {
+        printf("- Migration size is the buffer size argument; Moved is the sampled share of pages found on the target node\n");
+    }
+    if (run_autonuma) {
+        printf("- AutoNUMA overhead is time spent below the final bandwidth before convergence; counters are system-wide\n");
+    }
+    if (run_aging) {
+        printf("- Aging RSS is the growth over the process RSS before the heap was built; live size is the size argument\n");
+    }
+    if (run_openmp) {
+        printf("- OpenMP times include a fork/join per pass; pthread times run from the first start to the last end\n");
+    }
+    if (report_path) {
+        if (write_html_report(report_path, buffer_size, &sweep) == 0) {
+            printf("- Report written to %s\n", report_path);
+        } else {
+            fprintf(stderr, "Failed to write report to %s\n", report_path);
+        }
+    }
+    if (history_path) {
+        int appended = append_history(history_path, buffer_size, num_threads);
+        if (appended >= 0) {
+            printf("- %d results appended to %s (host %016llx)\n", appended, history_path,
+                   (unsigned long long)host_fingerprint());
+        } else {
+            fprintf(stderr, "Failed to append results to %s\n", history_path);
+        }
+    }
+    if (trace_json_path) {
+        if (trace_write_json(trace_json_path) == 0) {
+            printf("- Trace written to %s (open in ui.perfetto.dev or chrome://tracing)\n", trace_json_path);
+        } else {
+            fprintf(stderr, "Failed to write trace to %s\n", trace_json_path);
+        }
+        trace_disable();
+    }
     printf("- Results may vary based on CPU cache, memory type, and system load\n");
     
     // Cleanup
     free(buffer1);
     free(buffer2);
+    free(report_latency.items);
+    free(report_bandwidth.items);
     
     return 0;
 }
+#endif
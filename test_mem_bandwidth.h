@@ -0,0 +1,44 @@
+// Helpers from test_mem_bandwidth.c shared with the C++ benchmark targets.
+// Those targets link test_mem_bandwidth.c compiled with -DNO_MAIN.
+#ifndef TEST_MEM_BANDWIDTH_H
+#define TEST_MEM_BANDWIDTH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ITERATIONS 3
+#define LATENCY_ACCESSES 1000000  // Reduced for pointer chasing - each access is serialized
+#define MB_TO_BYTES(mb) ((size_t)(mb) * 1024 * 1024)
+#define KB_TO_BYTES(kb) ((size_t)(kb) * 1024)
+#define HUGEPAGE_SIZE MB_TO_BYTES(2)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cache hierarchy
+void read_cache_info(void);
+void display_cache_hierarchy(void);
+const char* analyze_cache_level(size_t buffer_size, double latency_ns);
+size_t find_cache_size(int level, size_t fallback);
+
+// Test sizes around each cache level, as used by the latency tests
+void generate_dynamic_test_sizes(size_t** test_sizes, char*** size_names, int* num_tests);
+void free_dynamic_test_sizes(size_t* test_sizes, char** size_names, int num_tests);
+
+// Timing, allocation and output
+double get_time(void);
+void init_random(void);
+void* aligned_malloc(size_t alignment, size_t size);
+void display_bandwidth(const char* test_name, double time_taken, size_t data_size, int iterations);
+void display_latency(const char* test_name, double time_taken, size_t num_accesses, size_t buffer_size);
+
+// Hugepage-backed memory: MAP_HUGETLB when reserved pages exist, else THP
+void* alloc_huge_chunk(size_t size, const char** kind);
+void free_huge_chunk(void* p, size_t size, const char* kind);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,263 @@
+// Polymorphic allocator (std::pmr) memory resources under container
+// workloads: build/lookup/teardown cycles of pmr vector, unordered_map and
+// string with new_delete_resource, and monotonic and pool resources carved
+// out of a hugepage arena.
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "test_mem_bandwidth.h"
+
+#define PMR_DEFAULT_ELEMENTS (1 << 20)  // Elements per container per cycle
+#define PMR_ARENA_BYTES_PER_ELEMENT 384 // Arena sized for monotonic strings (about 250 B/element) plus headroom
+#define PMR_STRING_MIN 16               // String lengths start past the libstdc++ SSO capacity
+#define PMR_STRING_MAX 64
+
+// Bump allocator over one hugepage chunk. Deallocation is a no-op; reset()
+// reclaims everything between cycles. high_water() is the footprint.
+class arena_resource : public std::pmr::memory_resource {
+public:
+    explicit arena_resource(size_t size) : size_(size) {
+        base_ = static_cast<char*>(alloc_huge_chunk(size, &kind_));
+    }
+    ~arena_resource() override {
+        if (base_) free_huge_chunk(base_, size_, kind_);
+    }
+    bool valid() const { return base_ != nullptr; }
+    const char* kind() const { return kind_; }
+    size_t high_water() const { return high_water_; }
+    void reset() {
+        used_ = 0;
+        high_water_ = 0;
+    }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        size_t offset = (used_ + alignment - 1) & ~(alignment - 1);
+        if (offset + bytes > size_) throw std::bad_alloc();
+        used_ = offset + bytes;
+        high_water_ = std::max(high_water_, used_);
+        return base_ + offset;
+    }
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    char* base_ = nullptr;
+    size_t size_;
+    size_t used_ = 0;
+    size_t high_water_ = 0;
+    const char* kind_ = "";
+};
+
+// Pass-through resource counting the bytes the containers hold
+class counting_resource : public std::pmr::memory_resource {
+public:
+    explicit counting_resource(std::pmr::memory_resource* upstream) : upstream_(upstream) {}
+    size_t live() const { return live_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* p = upstream_->allocate(bytes, alignment);
+        live_ += bytes;
+        return p;
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        upstream_->deallocate(p, bytes, alignment);
+        live_ -= bytes;
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    size_t live_ = 0;
+};
+
+enum resource_kind { RES_NEW_DELETE, RES_MONOTONIC, RES_UNSYNC_POOL, RES_SYNC_POOL, RES_COUNT };
+enum workload_kind { WORK_VECTOR, WORK_UNORDERED_MAP, WORK_STRING, WORK_COUNT };
+
+static const char* resource_names[RES_COUNT] = {"new_delete", "monotonic", "unsync_pool", "sync_pool"};
+static const char* workload_names[WORK_COUNT] = {"vector", "unordered_map", "string"};
+
+// Timing and footprint of one build/lookup/teardown cycle
+typedef struct {
+    uint64_t ops;
+    double build_time;     // Build plus lookups
+    double teardown_time;  // Container destruction plus resource release
+    size_t live_bytes;     // Held by the containers before teardown
+    size_t footprint;      // Backing memory before teardown
+} pmr_cycle_t;
+
+static volatile uint64_t sink;
+
+// Heap in use by malloc, for the new_delete footprint
+static size_t malloc_in_use(void) {
+    struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+}
+
+static std::unique_ptr<std::pmr::memory_resource> make_resource(int kind, arena_resource* arena) {
+    switch (kind) {
+    case RES_MONOTONIC:
+        return std::make_unique<std::pmr::monotonic_buffer_resource>(arena);
+    case RES_UNSYNC_POOL:
+        return std::make_unique<std::pmr::unsynchronized_pool_resource>(arena);
+    case RES_SYNC_POOL:
+        return std::make_unique<std::pmr::synchronized_pool_resource>(arena);
+    default:
+        return nullptr;
+    }
+}
+
+// Build the container, run its lookups, and leave it alive for the caller
+// to measure before teardown. Returns the operation count.
+static uint64_t run_workload(int work, std::pmr::memory_resource* mr, const std::vector<uint64_t>& keys,
+                             std::unique_ptr<std::pmr::vector<uint64_t>>& vec,
+                             std::unique_ptr<std::pmr::unordered_map<uint64_t, uint64_t>>& map,
+                             std::unique_ptr<std::pmr::vector<std::pmr::string>>& strings) {
+    size_t n = keys.size();
+    uint64_t sum = 0;
+    switch (work) {
+    case WORK_VECTOR:
+        // Growth by push_back so the resource sees every reallocation
+        vec = std::make_unique<std::pmr::vector<uint64_t>>(mr);
+        for (size_t i = 0; i < n; i++) vec->push_back(keys[i]);
+        for (uint64_t v : *vec) sum += v;
+        sink = sum;
+        return n;
+    case WORK_UNORDERED_MAP:
+        map = std::make_unique<std::pmr::unordered_map<uint64_t, uint64_t>>(mr);
+        for (size_t i = 0; i < n; i++) map->emplace(keys[i], i);
+        for (size_t i = 0; i < n; i++) sum += map->find(keys[n - 1 - i])->second;
+        sink = sum;
+        return 2 * n;
+    case WORK_STRING:
+        strings = std::make_unique<std::pmr::vector<std::pmr::string>>(mr);
+        for (size_t i = 0; i < n; i++) {
+            size_t len = PMR_STRING_MIN + keys[i] % (PMR_STRING_MAX - PMR_STRING_MIN + 1);
+            strings->emplace_back(len, (char)('a' + keys[i] % 26));
+        }
+        for (size_t i = 0; i < n; i++) sum += (*strings)[keys[i]].size();
+        sink = sum;
+        return n;
+    }
+    return 0;
+}
+
+static pmr_cycle_t run_cycle(int res, int work, arena_resource* arena, const std::vector<uint64_t>& keys) {
+    pmr_cycle_t cycle = {};
+    arena->reset();
+    size_t heap_before = malloc_in_use();
+
+    std::unique_ptr<std::pmr::memory_resource> resource = make_resource(res, arena);
+    counting_resource counter(resource ? resource.get() : std::pmr::new_delete_resource());
+    // Declared after the resources so an exception unwinds them first
+    std::unique_ptr<std::pmr::vector<uint64_t>> vec;
+    std::unique_ptr<std::pmr::unordered_map<uint64_t, uint64_t>> map;
+    std::unique_ptr<std::pmr::vector<std::pmr::string>> strings;
+
+    double start_time = get_time();
+    cycle.ops = run_workload(work, &counter, keys, vec, map, strings);
+    cycle.build_time = get_time() - start_time;
+
+    cycle.live_bytes = counter.live();
+    cycle.footprint = resource ? arena->high_water() : malloc_in_use() - heap_before;
+
+    start_time = get_time();
+    vec.reset();
+    map.reset();
+    strings.reset();
+    resource.reset();
+    cycle.teardown_time = get_time() - start_time;
+    return cycle;
+}
+
+int main(int argc, char* argv[]) {
+    size_t elements = PMR_DEFAULT_ELEMENTS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--elements") == 0 && i + 1 < argc) {
+            long n = atol(argv[++i]);
+            if (n < 1) {
+                fprintf(stderr, "Invalid element count: %s\n", argv[i]);
+                return 1;
+            }
+            elements = (size_t)n;
+        } else if (strcmp(argv[i], "--help") == 0) {
+            printf("Usage: %s [options]\n", argv[0]);
+            printf("  --elements N     Elements per container per cycle (default: %d)\n", PMR_DEFAULT_ELEMENTS);
+            printf("  --help           Show this message\n");
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    size_t arena_size = (elements * PMR_ARENA_BYTES_PER_ELEMENT + HUGEPAGE_SIZE - 1) / HUGEPAGE_SIZE * HUGEPAGE_SIZE;
+    arena_resource arena(arena_size);
+    if (!arena.valid()) {
+        fprintf(stderr, "Failed to allocate %zu MB arena for pmr tests\n", arena_size / MB_TO_BYTES(1));
+        return 1;
+    }
+
+    printf("pmr Memory Resource Test\n");
+    printf("===========================\n");
+    printf("Elements per container: %zu\n", elements);
+    printf("Cycles per result: %d\n", ITERATIONS);
+    printf("Arena: %zu MB (%s, prefaulted)\n", arena_size / MB_TO_BYTES(1), arena.kind());
+
+    // Keys are a random permutation so string lookups can index by key
+    std::vector<uint64_t> keys(elements);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+
+    for (int work = 0; work < WORK_COUNT; work++) {
+        printf("\n%s:\n", workload_names[work]);
+        printf("%-12s %10s %12s %12s %12s %12s %8s\n",
+               "Resource", "Mops/s", "Build ms", "Teardown ms", "Live MB", "Footprint MB", "Ratio");
+        printf("--------------------------------------------------------------------------------\n");
+        for (int res = 0; res < RES_COUNT; res++) {
+            pmr_cycle_t total = {};
+            try {
+                for (int iter = 0; iter < ITERATIONS; iter++) {
+                    pmr_cycle_t cycle = run_cycle(res, work, &arena, keys);
+                    total.ops += cycle.ops;
+                    total.build_time += cycle.build_time;
+                    total.teardown_time += cycle.teardown_time;
+                    total.live_bytes = std::max(total.live_bytes, cycle.live_bytes);
+                    total.footprint = std::max(total.footprint, cycle.footprint);
+                }
+            } catch (const std::bad_alloc&) {
+                fprintf(stderr, "%s/%s: arena exhausted\n", workload_names[work], resource_names[res]);
+                continue;
+            }
+            double seconds = total.build_time + total.teardown_time;
+            printf("%-12s %10.2f %12.2f %12.2f %12.1f %12.1f %8.2f\n", resource_names[res],
+                   total.ops / seconds / 1e6,
+                   total.build_time / ITERATIONS * 1e3, total.teardown_time / ITERATIONS * 1e3,
+                   (double)total.live_bytes / MB_TO_BYTES(1), (double)total.footprint / MB_TO_BYTES(1),
+                   total.live_bytes ? (double)total.footprint / total.live_bytes : 0.0);
+        }
+    }
+
+    printf("\nNotes:\n");
+    printf("- Each cycle builds the container, runs its lookups, then destroys it and its resource\n");
+    printf("- Ops: vector push_back, unordered_map insert + find, string construct + index; Mops/s includes teardown\n");
+    printf("- Live is what the containers hold before teardown; Footprint is arena high water (malloc in-use for new_delete)\n");
+    printf("- monotonic never reuses freed memory, so vector growth and rehashing stay in its footprint\n");
+    printf("- Pools draw chunks from the arena; sync_pool runs single-threaded here, so it shows locking cost only\n");
+    return 0;
+}